@@ -0,0 +1,111 @@
+#include "AssetManager.h"
+#include <iostream>
+
+template <typename T>
+AssetManager::Pending<T> AssetManager::startLoad(const std::string& path) {
+    return std::async(std::launch::async, [path]() -> AssetHandle<T> {
+        auto asset = std::make_shared<T>();
+        if (!asset->loadFromFile(path)) {
+            return nullptr;
+        }
+        return asset;
+    }).share();
+}
+
+template <typename T>
+AssetHandle<T> AssetManager::wait(const Pending<T>& pending, const std::string& path) {
+    AssetHandle<T> asset = pending.get();
+    if (!asset) {
+        std::cerr << "Error: Could not load " << path << std::endl;
+    }
+    return asset;
+}
+
+void AssetManager::preloadImages(const std::vector<std::string>& paths) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::string& path : paths) {
+        if (images.find(path) == images.end()) {
+            images.emplace(path, startLoad<sf::Image>(path));
+        }
+    }
+}
+
+void AssetManager::preloadFont(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (fonts.find(path) == fonts.end()) {
+        fonts.emplace(path, startLoad<sf::Font>(path));
+    }
+}
+
+AssetHandle<sf::Image> AssetManager::getImage(const std::string& path) {
+    Pending<sf::Image> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = images.find(path);
+        if (found == images.end()) {
+            found = images.emplace(path, startLoad<sf::Image>(path)).first;
+        }
+        pending = found->second;
+    }
+    // Waited on outside the lock so other threads can keep requesting assets
+    return wait(pending, path);
+}
+
+AssetHandle<sf::Font> AssetManager::getFont(const std::string& path) {
+    Pending<sf::Font> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = fonts.find(path);
+        if (found == fonts.end()) {
+            found = fonts.emplace(path, startLoad<sf::Font>(path)).first;
+        }
+        pending = found->second;
+    }
+    return wait(pending, path);
+}
+
+AssetHandle<sf::Texture> AssetManager::getTexture(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = textures.find(path);
+        if (found != textures.end()) {
+            return found->second;
+        }
+    }
+
+    AssetHandle<sf::Image> image = getImage(path);
+    if (!image) {
+        return nullptr;
+    }
+    auto texture = std::make_shared<sf::Texture>();
+    if (!texture->loadFromImage(*image)) {
+        std::cerr << "Error: Could not create a texture from " << path << std::endl;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return textures.emplace(path, std::move(texture)).first->second;
+}
+
+void AssetManager::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    // The cache's own reference is the only one left when use_count is 1
+    auto unused = [](const auto& pending) {
+        return pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+               pending.get().use_count() <= 1;
+    };
+    for (auto it = images.begin(); it != images.end();) {
+        it = unused(it->second) ? images.erase(it) : std::next(it);
+    }
+    for (auto it = fonts.begin(); it != fonts.end();) {
+        it = unused(it->second) ? fonts.erase(it) : std::next(it);
+    }
+    for (auto it = textures.begin(); it != textures.end();) {
+        it = it->second.use_count() <= 1 ? textures.erase(it) : std::next(it);
+    }
+}
+
+size_t AssetManager::getCachedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return images.size() + fonts.size() + textures.size();
+}
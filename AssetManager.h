@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Shared, read-only handle to a loaded asset. Copies are cheap and every holder sees the same
+// object, so nothing needs its own copy of a texture.
+template <typename T>
+using AssetHandle = std::shared_ptr<const T>;
+
+// Loads images, textures and fonts once per path and hands out shared handles.
+// Images and fonts are decoded on background threads as soon as they are requested, so
+// several files load in parallel while the caller does other startup work. Textures are
+// uploaded on the calling thread (it must be the one with the window's GL context).
+class AssetManager {
+public:
+    // Start loading in the background. Paths already requested are left alone.
+    void preloadImages(const std::vector<std::string>& paths);
+    void preloadFont(const std::string& path);
+
+    // Wait for the asset if it is still loading. Null (and an error printed) if it failed.
+    AssetHandle<sf::Image> getImage(const std::string& path);
+    AssetHandle<sf::Font> getFont(const std::string& path);
+    AssetHandle<sf::Texture> getTexture(const std::string& path);
+
+    // Drop cached assets that nobody else holds a handle to, e.g. images once they've been
+    // packed into an atlas. Assets still loading are kept.
+    void trim();
+
+    size_t getCachedCount() const;
+
+private:
+    template <typename T>
+    using Pending = std::shared_future<AssetHandle<T>>;
+
+    template <typename T>
+    static Pending<T> startLoad(const std::string& path);
+
+    template <typename T>
+    static AssetHandle<T> wait(const Pending<T>& pending, const std::string& path);
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Pending<sf::Image>> images;
+    std::unordered_map<std::string, Pending<sf::Font>> fonts;
+    std::unordered_map<std::string, AssetHandle<sf::Texture>> textures;
+};
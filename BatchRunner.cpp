@@ -0,0 +1,162 @@
+#include "BatchRunner.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include "challanProcess.h"
+
+// Two-sided 95% Student's t quantiles for 1..30 degrees of freedom
+const double T_QUANTILE_95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double tQuantile95(size_t degreesOfFreedom) {
+    if (degreesOfFreedom == 0) {
+        return 0.0;
+    }
+    if (degreesOfFreedom <= 30) {
+        return T_QUANTILE_95[degreesOfFreedom - 1];
+    }
+    return degreesOfFreedom <= 60 ? 2.000 : degreesOfFreedom <= 120 ? 1.980 : 1.960;
+}
+
+BatchRunner::BatchRunner(const BatchConfig& config)
+    : config(config) {
+    this->config.replications = std::max(this->config.replications, 1);
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = config.threads > 0 ? config.threads : static_cast<int>(cores);
+    threadCount = std::min(threadCount, this->config.replications);
+}
+
+ReplicationResult BatchRunner::runReplication(int index) const {
+    SimConfig scenario = config.scenario;
+    scenario.seed = config.baseSeed + static_cast<unsigned int>(index);
+    IntersectionSim sim(scenario);
+
+    ReplicationResult result;
+    sim.setViolationHandler([&result](const SpeedViolation& violation) {
+        result.challanAmount += getChallanAmount(violation.type);
+    });
+    while (!sim.isFinished()) {
+        sim.step(config.timestep);
+    }
+
+    const SimStats& stats = sim.getStats();
+    result.seed = scenario.seed;
+    result.vehiclesSpawned = stats.vehiclesSpawned;
+    result.vehiclesCleared = stats.vehiclesCleared;
+    result.throughputPerMinute = sim.getThroughputPerMinute();
+    result.averageDelay = sim.getAverageDelay();
+    result.violations = stats.violations;
+    return result;
+}
+
+void BatchRunner::run() {
+    results.assign(config.replications, ReplicationResult());
+    std::atomic<int> next{0};
+    auto worker = [&] {
+        // Each worker takes the next replication until none are left
+        for (int index = next.fetch_add(1); index < config.replications; index = next.fetch_add(1)) {
+            results[index] = runReplication(index);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+const std::vector<ReplicationResult>& BatchRunner::getResults() const {
+    return results;
+}
+
+int BatchRunner::getThreadCount() const {
+    return threadCount;
+}
+
+std::vector<MetricSummary> BatchRunner::summarize() const {
+    struct Metric {
+        const char* name;
+        double (*get)(const ReplicationResult&);
+    };
+    const Metric metrics[] = {
+        { "throughput_per_min", [](const ReplicationResult& r) { return r.throughputPerMinute; } },
+        { "average_delay_s", [](const ReplicationResult& r) { return r.averageDelay; } },
+        { "vehicles_cleared", [](const ReplicationResult& r) { return static_cast<double>(r.vehiclesCleared); } },
+        { "violations", [](const ReplicationResult& r) { return static_cast<double>(r.violations); } },
+        { "challan_amount", [](const ReplicationResult& r) { return r.challanAmount; } },
+    };
+
+    std::vector<MetricSummary> summaries;
+    size_t n = results.size();
+    for (const Metric& metric : metrics) {
+        MetricSummary summary = { metric.name, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        if (n == 0) {
+            summaries.push_back(summary);
+            continue;
+        }
+        double sum = 0.0;
+        summary.min = summary.max = metric.get(results.front());
+        for (const ReplicationResult& result : results) {
+            double value = metric.get(result);
+            sum += value;
+            summary.min = std::min(summary.min, value);
+            summary.max = std::max(summary.max, value);
+        }
+        summary.mean = sum / n;
+
+        double squares = 0.0;
+        for (const ReplicationResult& result : results) {
+            double deviation = metric.get(result) - summary.mean;
+            squares += deviation * deviation;
+        }
+        summary.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+        double halfWidth = tQuantile95(n - 1) * summary.stddev / std::sqrt(static_cast<double>(n));
+        summary.ciLow = summary.mean - halfWidth;
+        summary.ciHigh = summary.mean + halfWidth;
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+bool BatchRunner::writeCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error: Could not write " << path << std::endl;
+        return false;
+    }
+    file << "metric,replications,mean,stddev,ci95_low,ci95_high,min,max\n";
+    for (const MetricSummary& summary : summarize()) {
+        file << summary.name << ',' << results.size() << ',' << summary.mean << ',' << summary.stddev << ','
+             << summary.ciLow << ',' << summary.ciHigh << ',' << summary.min << ',' << summary.max << '\n';
+    }
+    file << "\nreplication,seed,spawned,cleared,throughput_per_min,average_delay_s,violations,challan_amount\n";
+    for (size_t r = 0; r < results.size(); ++r) {
+        const ReplicationResult& result = results[r];
+        file << r << ',' << result.seed << ',' << result.vehiclesSpawned << ',' << result.vehiclesCleared << ','
+             << result.throughputPerMinute << ',' << result.averageDelay << ',' << result.violations << ','
+             << result.challanAmount << '\n';
+    }
+    return true;
+}
+
+std::string BatchRunner::formatTable() const {
+    std::string table = "metric                    mean   95% CI                      stddev\n";
+    char line[128];
+    for (const MetricSummary& summary : summarize()) {
+        std::snprintf(line, sizeof(line), "%-20s %11.2f   [%11.2f, %11.2f] %10.2f\n",
+                      summary.name, summary.mean, summary.ciLow, summary.ciHigh, summary.stddev);
+        table += line;
+    }
+    return table;
+}
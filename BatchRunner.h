@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "IntersectionSim.h"
+
+struct BatchConfig {
+    SimConfig scenario;            // Run as-is except for the seed
+    float timestep = 1.0f / 60.0f;
+    int replications = 32;
+    unsigned int baseSeed = 1;     // Replication r runs with seed baseSeed + r
+    int threads = 0;               // 0 uses one per core
+};
+
+// Outcome of one replication
+struct ReplicationResult {
+    unsigned int seed = 0;
+    int vehiclesSpawned = 0;
+    int vehiclesCleared = 0;
+    double throughputPerMinute = 0.0;
+    double averageDelay = 0.0;     // Seconds per vehicle
+    int violations = 0;            // Every violation becomes a challan
+    double challanAmount = 0.0;    // Total payable over all challans issued
+};
+
+// Mean over the replications with a 95% confidence interval (Student's t)
+struct MetricSummary {
+    const char* name;
+    double mean;
+    double stddev;
+    double ciLow, ciHigh;
+    double min, max;
+};
+
+// Runs independent seeded replications of one scenario, one simulation per worker thread at
+// a time. Results are stored by replication index, so they don't depend on the thread count.
+class BatchRunner {
+public:
+    explicit BatchRunner(const BatchConfig& config);
+
+    void run();
+
+    const std::vector<ReplicationResult>& getResults() const;
+    std::vector<MetricSummary> summarize() const;
+    int getThreadCount() const;
+
+    // Summary rows followed by one row per replication
+    bool writeCsv(const std::string& path) const;
+    std::string formatTable() const;
+
+private:
+    ReplicationResult runReplication(int index) const;
+
+    BatchConfig config;
+    int threadCount;
+    std::vector<ReplicationResult> results;
+};
@@ -0,0 +1,342 @@
+#include "ChallanLedger.h"
+#include "Logger.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+struct LedgerHeader {
+    char magic[8];
+    std::uint32_t recordSize;
+    std::uint32_t reserved;
+};
+
+const char LEDGER_MAGIC[8] = { 'C', 'H', 'L', 'E', 'D', 'G', 'R', '2' };
+
+LedgerRecord makeIssuedRecord(const Challan& challan) {
+    LedgerRecord record = {};
+    record.kind = LedgerRecord::ISSUED;
+    record.status = challan.status;
+    record.payableAmount = challan.payableAmount;
+    record.challanID = challan.challanID;
+    record.vehicleID = challan.vehicleID;
+    record.issueTime = challan.issueTime;
+    record.dueTime = challan.dueTime;
+    return record;
+}
+
+// Writes the whole buffer, retrying short writes
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// A rename is only durable once the directory holding it is synced
+bool syncParentDirectory(const std::string& path) {
+    std::string::size_type slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int directoryFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (directoryFd < 0) {
+        return false;
+    }
+    bool ok = fsync(directoryFd) == 0;
+    ::close(directoryFd);
+    return ok;
+}
+
+} // namespace
+
+ChallanLedger::ChallanLedger(const std::string& path, size_t groupSize, std::chrono::milliseconds commitInterval)
+    : path(path), groupSize(groupSize), commitInterval(commitInterval) {
+    pending.reserve(groupSize);
+}
+
+ChallanLedger::~ChallanLedger() {
+    close();
+}
+
+bool ChallanLedger::replay(std::vector<Challan>& out, size_t& paymentCount) {
+    paymentCount = 0;
+    int readFd = ::open(path.c_str(), O_RDONLY);
+    if (readFd < 0) {
+        return true; // No ledger yet, nothing to replay
+    }
+
+    struct stat info;
+    if (fstat(readFd, &info) != 0 || info.st_size == 0) {
+        ::close(readFd);
+        return true;
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    if (fileSize < sizeof(LedgerHeader)) {
+        logError(path + " is too short to be a challan ledger");
+        ::close(readFd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, readFd, 0);
+    ::close(readFd);
+    if (mapped == MAP_FAILED) {
+        logError("Could not map " + path);
+        return false;
+    }
+
+    const char* bytes = static_cast<const char*>(mapped);
+    const LedgerHeader* header = reinterpret_cast<const LedgerHeader*>(bytes);
+    if (std::memcmp(header->magic, LEDGER_MAGIC, sizeof(LEDGER_MAGIC)) != 0 || header->recordSize != sizeof(LedgerRecord)) {
+        logError(path + " is not a challan ledger");
+        munmap(mapped, fileSize);
+        return false;
+    }
+    madvise(mapped, fileSize, MADV_SEQUENTIAL);
+
+    // A torn record at the end (crash mid-write) is ignored, open() cuts it off
+    size_t recordCount = (fileSize - sizeof(LedgerHeader)) / sizeof(LedgerRecord);
+    const LedgerRecord* records = reinterpret_cast<const LedgerRecord*>(bytes + sizeof(LedgerHeader));
+
+    // The ID index is only needed to fold payments, a compacted log has none
+    bool hasPayments = false;
+    for (size_t i = 0; i < recordCount && !hasPayments; ++i) {
+        hasPayments = records[i].kind == LedgerRecord::PAID;
+    }
+
+    std::unordered_map<ChallanNumber, size_t> byChallanID;
+    if (hasPayments) {
+        byChallanID.reserve(recordCount);
+    }
+    out.reserve(out.size() + recordCount);
+    for (size_t i = 0; i < recordCount; ++i) {
+        const LedgerRecord& record = records[i];
+        if (record.kind == LedgerRecord::ISSUED) {
+            if (hasPayments) {
+                byChallanID[record.challanID] = out.size();
+            }
+            out.push_back(Challan{
+                record.challanID,
+                record.vehicleID,
+                record.issueTime,
+                record.dueTime,
+                record.payableAmount,
+                record.status
+            });
+        } else if (record.kind == LedgerRecord::PAID) {
+            auto it = byChallanID.find(record.challanID);
+            if (it != byChallanID.end()) {
+                out[it->second].status = ChallanStatus::PAID;
+                ++paymentCount;
+            }
+        }
+    }
+
+    munmap(mapped, fileSize);
+    return true;
+}
+
+bool ChallanLedger::compact(const std::vector<Challan>& challans) {
+    // Write the folded log beside the old one and swap it in, so a crash leaves one or the other
+    std::string tempPath = path + ".compact";
+    int tempFd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (tempFd < 0) {
+        logError("Could not create " + tempPath);
+        return false;
+    }
+
+    bool ok = writeHeader(tempFd);
+    std::vector<LedgerRecord> batch;
+    batch.reserve(groupSize);
+    for (size_t i = 0; ok && i < challans.size(); ++i) {
+        batch.push_back(makeIssuedRecord(challans[i]));
+        if (batch.size() == groupSize || i + 1 == challans.size()) {
+            ok = writeAll(tempFd, batch.data(), batch.size() * sizeof(LedgerRecord));
+            batch.clear();
+        }
+    }
+    ok = ok && fsync(tempFd) == 0;
+    ok = ::close(tempFd) == 0 && ok;
+
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        logError("Could not compact " + path);
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    if (!syncParentDirectory(path)) {
+        logError("Could not sync the directory of " + path);
+        return false;
+    }
+    return true;
+}
+
+bool ChallanLedger::open() {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        logError("Could not open " + path);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        logError("Could not stat " + path);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    if (fileSize < sizeof(LedgerHeader)) {
+        if (ftruncate(fd, 0) != 0 || !writeHeader(fd)) {
+            logError("Could not initialise " + path);
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+    } else {
+        // Drop a torn trailing record so new records stay aligned
+        size_t whole = sizeof(LedgerHeader) + (fileSize - sizeof(LedgerHeader)) / sizeof(LedgerRecord) * sizeof(LedgerRecord);
+        // Appending after a torn record would misalign everything after it
+        if (whole != fileSize && ftruncate(fd, static_cast<off_t>(whole)) != 0) {
+            logError("Could not repair " + path);
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        if (lseek(fd, static_cast<off_t>(whole), SEEK_SET) < 0) {
+            logError("Could not seek to the end of " + path);
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+    }
+
+    stopping = false;
+    failed = false;
+    commitThread = std::thread(&ChallanLedger::commitLoop, this);
+    return true;
+}
+
+bool ChallanLedger::writeHeader(int targetFd) {
+    LedgerHeader header = {};
+    std::memcpy(header.magic, LEDGER_MAGIC, sizeof(LEDGER_MAGIC));
+    header.recordSize = sizeof(LedgerRecord);
+    return writeAll(targetFd, &header, sizeof(header));
+}
+
+bool ChallanLedger::appendIssued(const Challan& challan) {
+    return append(makeIssuedRecord(challan));
+}
+
+bool ChallanLedger::appendIssued(const Challan* challans, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failed) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        pending.push_back(makeIssuedRecord(challans[i]));
+    }
+    appendedCount += count;
+    if (pending.size() >= groupSize) {
+        commitNeeded.notify_one();
+    }
+    return true;
+}
+
+bool ChallanLedger::appendPaid(ChallanNumber challanID) {
+    LedgerRecord record = {};
+    record.kind = LedgerRecord::PAID;
+    record.status = ChallanStatus::PAID;
+    record.challanID = challanID;
+    return append(record);
+}
+
+bool ChallanLedger::append(const LedgerRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failed) {
+        return false;
+    }
+    pending.push_back(record);
+    ++appendedCount;
+    if (pending.size() >= groupSize) {
+        commitNeeded.notify_one();
+    }
+    return true;
+}
+
+bool ChallanLedger::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (fd < 0) {
+        return !failed;
+    }
+    std::uint64_t target = appendedCount;
+    flushRequested = true;
+    commitNeeded.notify_one();
+    committed.wait(lock, [&] { return committedCount >= target || failed; });
+    return !failed;
+}
+
+void ChallanLedger::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0) {
+            return;
+        }
+        stopping = true;
+    }
+    commitNeeded.notify_one();
+    if (commitThread.joinable()) {
+        commitThread.join();
+    }
+    ::close(fd);
+    fd = -1;
+}
+
+void ChallanLedger::commitLoop() {
+    std::vector<LedgerRecord> batch;
+    batch.reserve(groupSize);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        commitNeeded.wait_for(lock, commitInterval, [&] {
+            return stopping || flushRequested || pending.size() >= groupSize;
+        });
+        flushRequested = false;
+        if (pending.empty()) {
+            if (stopping) {
+                break;
+            }
+            continue;
+        }
+
+        // Write outside the lock so appends carry on into the next batch meanwhile
+        batch.swap(pending);
+        lock.unlock();
+        bool written = writeAll(fd, batch.data(), batch.size() * sizeof(LedgerRecord)) && fdatasync(fd) == 0;
+        lock.lock();
+
+        if (!written) {
+            // Nothing after this point can be trusted to reach the disk, so stop taking records
+            // rather than report them committed. flush() and the appends return false from now on.
+            logError("Could not write to " + path + ", no further challans will be recorded in it");
+            failed = true;
+            pending.clear();
+            committed.notify_all();
+            break;
+        }
+        committedCount += batch.size();
+        batch.clear();
+        committed.notify_all();
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ChallanStore.h"
+
+// One fixed-size entry in the ledger file. ISSUED carries the whole challan, PAID only
+// needs the challan ID.
+struct LedgerRecord {
+    enum Kind : std::uint8_t { ISSUED = 1, PAID = 2 };
+
+    std::uint8_t kind;
+    ChallanStatus status;
+    std::uint8_t reserved[2];
+    float payableAmount;
+    ChallanNumber challanID;
+    PlateNumber vehicleID;
+    std::int64_t issueTime;
+    std::int64_t dueTime;
+};
+static_assert(sizeof(LedgerRecord) == 32, "ledger records must stay fixed-size");
+
+// Append-only challan log. Appends only copy the record into a pending batch; a commit
+// thread writes the batch and syncs it once it is full or commitInterval has passed, so
+// one disk sync covers many challans. Startup replays the file through mmap and folds
+// payments into their challans, compact() rewrites the file with the folded records only.
+class ChallanLedger {
+public:
+    explicit ChallanLedger(const std::string& path, size_t groupSize = 256,
+                           std::chrono::milliseconds commitInterval = std::chrono::milliseconds(50));
+    ~ChallanLedger();
+
+    // Read the existing log (if any) into out, in issue order with payments applied.
+    // Call before open(). Returns false if the file exists but is not a ledger.
+    bool replay(std::vector<Challan>& out, size_t& paymentCount);
+
+    // Rewrite the log so it holds one ISSUED record per challan. Call before open().
+    bool compact(const std::vector<Challan>& challans);
+
+    // Open for appending and start the commit thread
+    bool open();
+
+    // Appends return false once a commit has failed, the records are not taken
+    bool appendIssued(const Challan& challan);
+    bool appendIssued(const Challan* challans, size_t count);
+    bool appendPaid(ChallanNumber challanID);
+
+    // Block until everything appended so far is on disk. False if a commit failed, in which
+    // case nothing appended since the last successful commit is durable.
+    bool flush();
+
+    // Commit what is pending and stop the commit thread
+    void close();
+
+    const std::string& getPath() const { return path; }
+
+private:
+    void commitLoop();
+    bool append(const LedgerRecord& record);
+    bool writeHeader(int fd);
+
+    std::string path;
+    size_t groupSize;
+    std::chrono::milliseconds commitInterval;
+    int fd = -1;
+
+    std::mutex mutex;
+    std::condition_variable commitNeeded;   // Wakes the commit thread early
+    std::condition_variable committed;      // Wakes flush() callers
+    std::vector<LedgerRecord> pending;
+    std::uint64_t appendedCount = 0;
+    std::uint64_t committedCount = 0;
+    bool flushRequested = false;
+    bool failed = false;                    // A write or sync failed, the commit thread has stopped
+    bool stopping = false;
+    std::thread commitThread;
+};
@@ -0,0 +1,152 @@
+#include "ChallanStore.h"
+#include "ChallanLedger.h"
+#include <algorithm>
+
+const char* toString(ChallanStatus status) {
+    switch (status) {
+        case ChallanStatus::INACTIVE: return "Inactive";
+        case ChallanStatus::ACTIVE: return "Active";
+        case ChallanStatus::PAID: return "Paid";
+    }
+    return "Unknown";
+}
+
+void ChallanStore::setLedger(ChallanLedger* newLedger) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    ledger = newLedger;
+}
+
+Challan& ChallanStore::record(size_t index) {
+    return segments[index / CHALLAN_SEGMENT_SIZE]->records[index % CHALLAN_SEGMENT_SIZE];
+}
+
+const Challan& ChallanStore::record(size_t index) const {
+    return segments[index / CHALLAN_SEGMENT_SIZE]->records[index % CHALLAN_SEGMENT_SIZE];
+}
+
+void ChallanStore::append(const Challan& challan) {
+    if (count % CHALLAN_SEGMENT_SIZE == 0) {
+        segments.push_back(std::make_shared<ChallanSegment>());
+    }
+    size_t index = count++;
+    record(index) = challan;
+    // A repeated challan ID points at the newest record
+    byChallanID[challan.challanID] = index;
+    byVehicleID[challan.vehicleID].push_back(index);
+}
+
+void ChallanStore::load(std::vector<Challan> challans) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    segments.clear();
+    count = 0;
+    byChallanID.clear();
+    byVehicleID.clear();
+    byChallanID.reserve(challans.size());
+    for (const Challan& challan : challans) {
+        append(challan);
+    }
+    ++version;
+}
+
+void ChallanStore::add(const Challan& challan) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    append(challan);
+    ++version;
+    if (ledger) {
+        ledger->appendIssued(challan);
+    }
+}
+
+void ChallanStore::addBatch(const Challan* challans, size_t count) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (size_t i = 0; i < count; ++i) {
+        append(challans[i]);
+    }
+    ++version;
+    if (ledger) {
+        ledger->appendIssued(challans, count);
+    }
+}
+
+bool ChallanStore::findByChallanID(ChallanNumber challanID, Challan& out) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = byChallanID.find(challanID);
+    if (it == byChallanID.end()) {
+        return false;
+    }
+    out = record(it->second);
+    return true;
+}
+
+std::vector<Challan> ChallanStore::findByVehicleID(PlateNumber vehicleID) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<Challan> result;
+    auto it = byVehicleID.find(vehicleID);
+    if (it != byVehicleID.end()) {
+        result.reserve(it->second.size());
+        for (size_t index : it->second) {
+            result.push_back(record(index));
+        }
+    }
+    return result;
+}
+
+PaymentResult ChallanStore::pay(PlateNumber vehicleID, ChallanNumber challanID, double amount) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = byChallanID.find(challanID);
+    if (it == byChallanID.end() || record(it->second).vehicleID != vehicleID) {
+        return PaymentResult::NOT_FOUND;
+    }
+    // Paying again would only append another PAID record to the ledger
+    if (record(it->second).status == ChallanStatus::PAID) {
+        return PaymentResult::ALREADY_PAID;
+    }
+    if (amount != record(it->second).payableAmount) {
+        return PaymentResult::WRONG_AMOUNT;
+    }
+    // Copy the segment first if a snapshot still holds it. Only this lock adds references,
+    // so a count of one can't go up underneath us.
+    std::shared_ptr<ChallanSegment>& segment = segments[it->second / CHALLAN_SEGMENT_SIZE];
+    if (segment.use_count() > 1) {
+        segment = std::make_shared<ChallanSegment>(*segment);
+    }
+    Challan& challan = record(it->second);
+    challan.status = ChallanStatus::PAID;
+    ++version;
+    if (ledger) {
+        ledger->appendPaid(challanID);
+    }
+    return PaymentResult::PAID;
+}
+
+ChallanStore::Snapshot ChallanStore::snapshot() const {
+    // snapshotMutex only serialises rebuilds between readers, writers never take it
+    std::lock_guard<std::mutex> snapshotLock(snapshotMutex);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        if (version == snapshotVersion) {
+            return cachedSnapshot;
+        }
+    }
+    // Allocated outside the lock so it only covers pointer copies and the tail
+    auto snapshot = std::make_shared<ChallanSnapshot>();
+    auto tail = std::make_shared<ChallanSegment>();
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        size_t full = count / CHALLAN_SEGMENT_SIZE, tailCount = count % CHALLAN_SEGMENT_SIZE;
+        snapshot->segments.assign(segments.begin(), segments.begin() + full);
+        if (tailCount > 0) {
+            std::copy(segments[full]->records, segments[full]->records + tailCount, tail->records);
+            snapshot->segments.push_back(std::move(tail));
+        }
+        snapshot->count = count;
+        snapshotVersion = version;
+    }
+    cachedSnapshot = std::move(snapshot);
+    return cachedSnapshot;
+}
+
+size_t ChallanStore::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return count;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include "Identifiers.h"
+#include "Vehicle.h"
+
+// 32 bytes with no heap storage. IDs and times are formatted only when shown on screen.
+struct Challan {
+    ChallanNumber challanID;
+    PlateNumber vehicleID;
+    std::int64_t issueTime;    // Epoch seconds
+    std::int64_t dueTime;      // Epoch seconds
+    float payableAmount;
+    ChallanStatus status;
+};
+
+const char* toString(ChallanStatus status);
+
+class ChallanLedger;
+
+enum class PaymentResult { PAID, WRONG_AMOUNT, NOT_FOUND, ALREADY_PAID };
+
+// Fixed block of challans. The store fills them in issue order and never reallocates one.
+const size_t CHALLAN_SEGMENT_SIZE = 4096;
+
+struct ChallanSegment {
+    Challan records[CHALLAN_SEGMENT_SIZE];
+};
+
+// Every challan as of one moment, in issue order. Full segments are shared with the store
+// (it copies a segment before changing one a snapshot still holds), only the partly filled
+// last segment is copied, so taking one costs a pointer per 4096 challans.
+class ChallanSnapshot {
+public:
+    class Iterator {
+    public:
+        Iterator(const ChallanSnapshot* snapshot, size_t index) : snapshot(snapshot), index(index) {}
+        const Challan& operator*() const { return (*snapshot)[index]; }
+        Iterator& operator++() { ++index; return *this; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+    private:
+        const ChallanSnapshot* snapshot;
+        size_t index;
+    };
+
+    size_t size() const { return count; }
+    const Challan& operator[](size_t index) const {
+        return segments[index / CHALLAN_SEGMENT_SIZE]->records[index % CHALLAN_SEGMENT_SIZE];
+    }
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, count); }
+
+private:
+    friend class ChallanStore;
+    std::vector<std::shared_ptr<const ChallanSegment>> segments;
+    size_t count = 0;
+};
+
+// Issued challans with O(1) lookup by challan ID and a secondary index from vehicle ID to
+// that vehicle's challans. Records live in fixed segments and are never moved once added,
+// so status changes are made in place (or in a fresh copy of a segment a snapshot holds).
+//
+// The challan workers write and the UI thread reads. Lookups take a shared lock and only
+// copy the records they return, so they never wait on each other and hold off issuance for
+// a hash lookup at most. Full listings go through snapshot(), which holds the shared lock
+// only to copy segment pointers and the unfilled tail, never the whole store.
+class ChallanStore {
+public:
+    using Snapshot = std::shared_ptr<const ChallanSnapshot>;
+
+    // Log every add and payment from now on (not owned, may be null)
+    void setLedger(ChallanLedger* ledger);
+
+    // Replace the contents with challans recovered from the ledger, without logging them again
+    void load(std::vector<Challan> challans);
+
+    void add(const Challan& challan);
+    // Same as add for every challan, under one lock
+    void addBatch(const Challan* challans, size_t count);
+
+    bool findByChallanID(ChallanNumber challanID, Challan& out) const;
+    std::vector<Challan> findByVehicleID(PlateNumber vehicleID) const;
+
+    // Mark the challan paid if it belongs to the vehicle, isn't paid yet and the amount matches
+    PaymentResult pay(PlateNumber vehicleID, ChallanNumber challanID, double amount);
+
+    // Every challan in the order they were issued, as of the last change. The snapshot
+    // stays valid (and unchanged) however long the caller keeps it.
+    Snapshot snapshot() const;
+    size_t size() const;
+
+private:
+    Challan& record(size_t index);
+    const Challan& record(size_t index) const;
+    void append(const Challan& challan);
+
+    mutable std::shared_mutex mutex;
+    std::vector<std::shared_ptr<ChallanSegment>> segments;         // Issue order, the last one may be partly filled
+    size_t count = 0;
+    std::unordered_map<ChallanNumber, size_t> byChallanID;         // Challan ID -> index in issue order
+    std::unordered_map<PlateNumber, std::vector<size_t>> byVehicleID;
+    std::uint64_t version = 0;                                     // Bumped on every add or pay
+    ChallanLedger* ledger = nullptr;                               // Appended to under the write lock, so log order matches
+
+    // Last snapshot handed out and the version it was taken at
+    mutable std::mutex snapshotMutex;
+    mutable Snapshot cachedSnapshot;
+    mutable std::uint64_t snapshotVersion = ~std::uint64_t(0);
+};
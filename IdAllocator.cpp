@@ -0,0 +1,89 @@
+#include "IdAllocator.h"
+
+namespace {
+
+// 32-bit integer hash (lowbias32), the Feistel round function
+std::uint32_t mix32(std::uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+} // namespace
+
+IdAllocator::IdAllocator(std::uint32_t domainSize, std::uint64_t key)
+    : domainSize(domainSize) {
+    int bits = 2;
+    while (bits < 32 && (std::uint64_t(1) << bits) < domainSize) {
+        bits += 2;
+    }
+    halfBits = bits / 2;
+    halfMask = (std::uint32_t(1) << halfBits) - 1;
+
+    for (int round = 0; round < ROUNDS; ++round) {
+        key = key * 6364136223846793005ull + 1442695040888963407ull;
+        roundKeys[round] = static_cast<std::uint32_t>(key >> 32);
+    }
+}
+
+std::uint32_t IdAllocator::permute(std::uint32_t value) const {
+    std::uint32_t left = value >> halfBits;
+    std::uint32_t right = value & halfMask;
+    for (int round = 0; round < ROUNDS; ++round) {
+        std::uint32_t next = left ^ (mix32(right ^ roundKeys[round]) & halfMask);
+        left = right;
+        right = next;
+    }
+    return (left << halfBits) | right;
+}
+
+// Runs the rounds backwards
+std::uint32_t IdAllocator::unpermute(std::uint32_t value) const {
+    std::uint32_t left = value >> halfBits;
+    std::uint32_t right = value & halfMask;
+    for (int round = ROUNDS - 1; round >= 0; --round) {
+        std::uint32_t previous = right ^ (mix32(left ^ roundKeys[round]) & halfMask);
+        right = left;
+        left = previous;
+    }
+    return (left << halfBits) | right;
+}
+
+std::uint32_t IdAllocator::idAt(std::uint64_t index) const {
+    std::uint32_t generation = static_cast<std::uint32_t>(index / domainSize);
+    std::uint32_t value = static_cast<std::uint32_t>(index % domainSize);
+
+    // The Feistel domain is at most 4x the ID domain, so this takes a few passes on average
+    do {
+        value = permute(value);
+    } while (value >= domainSize);
+
+    return value + generation * domainSize;
+}
+
+std::uint64_t IdAllocator::indexOf(std::uint32_t id) const {
+    std::uint32_t generation = id / domainSize;
+    std::uint32_t value = id % domainSize;
+
+    // Walks the same cycle as idAt in reverse, the values in between are all outside the domain
+    do {
+        value = unpermute(value);
+    } while (value >= domainSize);
+
+    return value + static_cast<std::uint64_t>(generation) * domainSize;
+}
+
+std::uint32_t IdAllocator::next() {
+    return idAt(counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+void IdAllocator::resume(std::uint64_t issuedCount) {
+    counter.store(issuedCount, std::memory_order_relaxed);
+}
+
+std::uint64_t IdAllocator::getIssuedCount() const {
+    return counter.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Hands out unique IDs in [0, domainSize) in a scrambled order: the n-th call returns a keyed
+// permutation of n. The permutation is a 4-round Feistel network over the smallest even bit
+// width that covers the domain, and results outside the domain are fed back through it (cycle
+// walking) until they land inside, so it stays a bijection on [0, domainSize).
+//
+// next() is one atomic increment plus a few multiplies, safe from any number of threads. Once
+// every ID in the domain is used the counter carries into a generation, returned above
+// domainSize (ID + generation * domainSize), so IDs stay unique up to 2^32 allocations.
+class IdAllocator {
+public:
+    IdAllocator(std::uint32_t domainSize, std::uint64_t key);
+
+    std::uint32_t next();
+
+    // The ID the index-th allocation returns
+    std::uint32_t idAt(std::uint64_t index) const;
+    // The allocation that returns id, the inverse of idAt
+    std::uint64_t indexOf(std::uint32_t id) const;
+
+    // Skip IDs already handed out by an earlier run with the same key
+    void resume(std::uint64_t issuedCount);
+    std::uint64_t getIssuedCount() const;
+
+private:
+    std::uint32_t permute(std::uint32_t value) const;
+    std::uint32_t unpermute(std::uint32_t value) const;
+
+    static const int ROUNDS = 4;
+
+    std::uint32_t domainSize;
+    int halfBits;
+    std::uint32_t halfMask;
+    std::uint32_t roundKeys[ROUNDS];
+    std::atomic<std::uint64_t> counter{0};
+};
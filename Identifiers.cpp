@@ -0,0 +1,79 @@
+#include "Identifiers.h"
+#include <cctype>
+#include <cstdint>
+
+namespace {
+
+// Writes value as letterCount letters then digitCount digits, then -generation if it has one
+std::string formatPacked(std::uint32_t value, int letterCount, int digitCount, std::uint32_t digitRange, std::uint32_t count) {
+    std::uint32_t generation = value / count;
+    value %= count;
+    std::string text(letterCount + digitCount, '0');
+    std::uint32_t letters = value / digitRange;
+    std::uint32_t digits = value % digitRange;
+    for (int i = letterCount - 1; i >= 0; --i) {
+        text[i] = static_cast<char>('A' + letters % 26);
+        letters /= 26;
+    }
+    for (int i = letterCount + digitCount - 1; i >= letterCount; --i) {
+        text[i] = static_cast<char>('0' + digits % 10);
+        digits /= 10;
+    }
+    if (generation > 0) {
+        text += "-" + std::to_string(generation);
+    }
+    return text;
+}
+
+bool parsePacked(const std::string& text, int letterCount, int digitCount, std::uint32_t digitRange, std::uint32_t count, std::uint32_t& value) {
+    size_t length = static_cast<size_t>(letterCount + digitCount);
+    std::uint64_t generation = 0;
+    if (text.size() > length + 1 && text[length] == '-') {
+        for (size_t i = length + 1; i < text.size(); ++i) {
+            if (!std::isdigit(static_cast<unsigned char>(text[i])) || generation > UINT32_MAX / count) {
+                return false;
+            }
+            generation = generation * 10 + static_cast<std::uint64_t>(text[i] - '0');
+        }
+    } else if (text.size() != length) {
+        return false;
+    }
+    if (generation * count + count - 1 > UINT32_MAX) {
+        return false;
+    }
+    std::uint32_t letters = 0;
+    std::uint32_t digits = 0;
+    for (int i = 0; i < letterCount; ++i) {
+        char c = static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
+        if (c < 'A' || c > 'Z') {
+            return false;
+        }
+        letters = letters * 26 + static_cast<std::uint32_t>(c - 'A');
+    }
+    for (int i = letterCount; i < letterCount + digitCount; ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(text[i]))) {
+            return false;
+        }
+        digits = digits * 10 + static_cast<std::uint32_t>(text[i] - '0');
+    }
+    value = static_cast<std::uint32_t>(generation * count) + letters * digitRange + digits;
+    return true;
+}
+
+} // namespace
+
+std::string formatPlate(PlateNumber plate) {
+    return formatPacked(plate, 3, 3, 1000, PLATE_COUNT);
+}
+
+std::string formatChallanNumber(ChallanNumber number) {
+    return formatPacked(number, 2, 4, 10000, CHALLAN_NUMBER_COUNT);
+}
+
+bool parsePlate(const std::string& text, PlateNumber& plate) {
+    return parsePacked(text, 3, 3, 1000, PLATE_COUNT, plate);
+}
+
+bool parseChallanNumber(const std::string& text, ChallanNumber& number) {
+    return parsePacked(text, 2, 4, 10000, CHALLAN_NUMBER_COUNT, number);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Plates and challan IDs are stored as integers and only turned into text for display.
+// A plate is 3 letters + 3 digits packed as letters * 1000 + digits (AAA000 is 0), a challan
+// ID is 2 letters + 4 digits packed as letters * 10000 + digits. Letters are base 26.
+// Values past the 6-character space (see IdAllocator) carry a generation, shown as a suffix:
+// PLATE_COUNT + 5 formats as "AAA005-1".
+using PlateNumber = std::uint32_t;
+using ChallanNumber = std::uint32_t;
+
+const std::uint32_t PLATE_COUNT = 26 * 26 * 26 * 1000;     // Distinct plates, AAA000 to ZZZ999
+const std::uint32_t CHALLAN_NUMBER_COUNT = 26 * 26 * 10000; // Distinct challan IDs, AA0000 to ZZ9999
+
+std::string formatPlate(PlateNumber plate);
+std::string formatChallanNumber(ChallanNumber number);
+
+// Parse typed-in text (case-insensitive, optional -generation suffix), false if it is not a
+// well-formed plate / challan ID
+bool parsePlate(const std::string& text, PlateNumber& plate);
+bool parseChallanNumber(const std::string& text, ChallanNumber& number);
@@ -0,0 +1,555 @@
+#include "IntersectionSim.h"
+#include <algorithm>
+#include <random>
+#include "Logger.h"
+#include "VehicleKernels.h"
+
+const Vec2 NORTH_SPAWN_REGULAR_LANE1 = {522, 0};    // Starting from top-center
+const Vec2 SOUTH_SPAWN_REGULAR_LANE1 = {403, 1000}; // Starting from bottom-center
+const Vec2 EAST_SPAWN_REGULAR_LANE1 = {1000, 533};  // Starting from right-center
+const Vec2 WEST_SPAWN_REGULAR_LANE1 = {0, 410};     // Starting from left-center
+
+const Vec2 NORTH_TURN_LANE1 = {405, 278}; // Starting from top-center
+const Vec2 SOUTH_TURN_LANE1 = {523, 715}; // Done
+const Vec2 EAST_TURN_LANE1 = {700, 467};  // DONE
+const Vec2 WEST_TURN_LANE1 = {290, 535};  // Starting from left-center
+
+
+const Vec2 NORTH_SPAWN_HEAVY_LANE2 = {580, 0};     // Starting from top-center
+const Vec2 SOUTH_SPAWN_HEAVY_LANE2 = {450, 1000};  // Starting from bottom-center
+const Vec2 EAST_SPAWN_HEAVY_LANE2 = {1000, 590};   // Starting from right-center
+const Vec2 WEST_SPAWN_HEAVY_LANE2 = {0, 460};      // Starting from left-center
+
+
+const Vec2 NORTH_TURN_LANE2 = {450, 278};    // Starting from top-center
+const Vec2 SOUTH_TURN_LANE2 = {575, 715};    // Done
+const Vec2 EAST_TURN_LANE2 = {700, 410};     // DONE
+const Vec2 WEST_TURN_LANE2 = {290, 590};     // Starting from left-center
+
+const int REGULAR_VEHICLE_SPEED_LIMIT = 60;
+const int HEAVY_VEHICLE_SPEED_LIMIT = 40;
+const int EMERGENCY_VEHICLE_SPEED_LIMIT = 80;
+
+const float MIN_VEHICLE_GAP = 50.0f;
+
+// The intersection image is 1000x1000, vehicles are removed once fully past its edge
+const float SCREEN_SIZE = 1000.0f;
+const float DESPAWN_MARGIN = 100.0f;
+
+// Spawn point for every approach lane, indexed [Direction][lane - 1]
+const Vec2 SPAWN_POINTS[DIRECTION_COUNT][2] = {
+    { NORTH_SPAWN_REGULAR_LANE1, NORTH_SPAWN_HEAVY_LANE2 },
+    { SOUTH_SPAWN_REGULAR_LANE1, SOUTH_SPAWN_HEAVY_LANE2 },
+    { EAST_SPAWN_REGULAR_LANE1, EAST_SPAWN_HEAVY_LANE2 },
+    { WEST_SPAWN_REGULAR_LANE1, WEST_SPAWN_HEAVY_LANE2 },
+};
+
+// Indexed by VehicleType (REGULAR, HEAVY, EMERGENCY)
+const int SPEED_LIMITS[VEHICLE_TYPE_COUNT] = { REGULAR_VEHICLE_SPEED_LIMIT, HEAVY_VEHICLE_SPEED_LIMIT, EMERGENCY_VEHICLE_SPEED_LIMIT };
+
+// Indexed by Direction (NORTH, SOUTH, EAST, WEST). Positions along an approach are measured
+// as "progress", so that ahead is always the larger value (NORTH: y, SOUTH: -y, EAST: -x, WEST: x).
+const float DIRECTION_X[DIRECTION_COUNT] = { 0.0f, 0.0f, -1.0f, 1.0f };
+const float DIRECTION_Y[DIRECTION_COUNT] = { 1.0f, -1.0f, 0.0f, 0.0f };
+
+// Vehicles wait here on a non-green light (NORTH: y >= 300, SOUTH: y <= 715, EAST: x <= 700, WEST: x >= 290)
+const float STOP_LINE[DIRECTION_COUNT] = { 300.0f, -715.0f, -700.0f, 290.0f };
+
+// Detection zone in front of the stop line, read by actuated signal control
+const float DETECTOR_LENGTH = 120.0f;
+
+// Vehicles pick their exit once past this point (NORTH: y > 350, SOUTH: y < 650, EAST: x < 650, WEST: x > 350)
+const float TURN_LINE[DIRECTION_COUNT] = { 350.0f, -650.0f, -650.0f, 350.0f };
+
+// Exit direction for each approach and turn (0 = LEFT, 1 = STRAIGHT, 2 = RIGHT)
+const Direction TURN_TABLE[DIRECTION_COUNT][3] = {
+    { Direction::EAST, Direction::NORTH, Direction::WEST },  // NORTH
+    { Direction::WEST, Direction::SOUTH, Direction::EAST },  // SOUTH
+    { Direction::SOUTH, Direction::EAST, Direction::NORTH }, // EAST
+    { Direction::NORTH, Direction::WEST, Direction::SOUTH }, // WEST
+};
+
+// Where a turned vehicle is placed for each exit direction, lane 1 and lane 2
+const Vec2 EXIT_LANE1[DIRECTION_COUNT] = { SOUTH_TURN_LANE1, NORTH_TURN_LANE1, WEST_TURN_LANE1, EAST_TURN_LANE1 };
+const Vec2 EXIT_LANE2[DIRECTION_COUNT] = { SOUTH_TURN_LANE2, NORTH_TURN_LANE2, WEST_TURN_LANE2, EAST_TURN_LANE2 };
+
+// Lane list for an approaching vehicle
+static int laneIndex(Direction direction, std::uint8_t lane) {
+    return static_cast<int>(direction) * 2 + (lane - 1);
+}
+
+int generateMockSpeed(VehicleType type, Xoshiro256& gen) {
+    int maxSpeed = (type == VehicleType::EMERGENCY) ? 75 : (type == VehicleType::REGULAR) ? 55 : 35;
+    return 1 + static_cast<int>(gen.nextBelow(maxSpeed));
+}
+
+IntersectionSim::IntersectionSim(const SimConfig& config)
+    : config(config),
+      signalController(makeSignalController(config.signalControl, config.signalPlan ? *config.signalPlan
+                                            : SignalPlan::makeFixedTime(config.cycleDuration, config.yellowDuration))),
+      rng(config.seed != 0 ? config.seed : std::random_device{}()),
+      plateIds(PLATE_COUNT, config.plateKey != 0 ? config.plateKey : rng.get(RandomStream::ID)()) {
+    if (config.signalControl == SignalControl::ACTUATED && config.signalPlan) {
+        logMessage(LogLevel::WARN, "The actuated signal controller ignores the signal plan");
+    }
+}
+
+void IntersectionSim::setSignalController(std::unique_ptr<SignalController> controller) {
+    signalController = std::move(controller);
+}
+
+const SignalController& IntersectionSim::getSignalController() const {
+    return *signalController;
+}
+
+void IntersectionSim::setViolationHandler(std::function<void(const SpeedViolation&)> handler) {
+    violationHandler = std::move(handler);
+}
+
+void IntersectionSim::setProfiler(StageProfiler* newProfiler) {
+    profiler = newProfiler;
+}
+
+bool IntersectionSim::isFinished() const {
+    return elapsedTime >= config.duration;
+}
+
+double IntersectionSim::getElapsedTime() const {
+    return elapsedTime;
+}
+
+const VehicleStore& IntersectionSim::getVehicles() const {
+    return vehicles;
+}
+
+const SignalState& IntersectionSim::getSignals() const {
+    return signals;
+}
+
+const SimStats& IntersectionSim::getStats() const {
+    return stats;
+}
+
+const VehicleCounts& IntersectionSim::getVehicleCounts() const {
+    return counts;
+}
+
+double IntersectionSim::getThroughputPerMinute() const {
+    if (elapsedTime <= 0.0) {
+        return 0.0;
+    }
+    return stats.vehiclesCleared / (elapsedTime / 60.0);
+}
+
+double IntersectionSim::getAverageDelay() const {
+    if (stats.vehiclesSpawned == 0) {
+        return 0.0;
+    }
+    return stats.totalDelay / stats.vehiclesSpawned;
+}
+
+void IntersectionSim::step(float dt) {
+    elapsedTime += dt;
+    northTimer += dt;
+    southTimer += dt;
+    eastTimer += dt;
+    westTimer += dt;
+    heavyCarTimer += dt;
+    northEmergencyTimer += dt;
+    southEmergencyTimer += dt;
+    eastEmergencyTimer += dt;
+    westEmergencyTimer += dt;
+    speedTimer += dt;
+    stats.vehicleSteps += vehicles.size();
+
+    {
+        ScopedStageTimer timer(profiler, Stage::SPAWN);
+        spawnVehicles();
+        receiveArrivals();
+    }
+    {
+        ScopedStageTimer timer(profiler, Stage::ADMIT);
+        admitVehicles();
+        spawnHeavyVehicles();
+    }
+    {
+        ScopedStageTimer timer(profiler, Stage::SIGNALS);
+        measureDemand();
+        signalController->update(dt, demand, signals);
+    }
+    {
+        ScopedStageTimer timer(profiler, Stage::VIOLATIONS);
+        updateSpeeds();
+        detectViolations();
+    }
+    {
+        ScopedStageTimer timer(profiler, Stage::MOVE);
+        moveVehicles(dt);
+    }
+    {
+        ScopedStageTimer timer(profiler, Stage::DESPAWN);
+        despawnVehicles();
+    }
+}
+
+void IntersectionSim::populate(size_t count) {
+    vehicles.reserve(vehicles.size() + count);
+    size_t perLane[LANE_COUNT] = {};
+    for (size_t k = 0; k < count; ++k) {
+        int laneSlot = static_cast<int>(k % LANE_COUNT);
+        Direction direction = static_cast<Direction>(laneSlot / 2);
+        int lane = laneSlot % 2 + 1;
+
+        // Line them up behind the spawn point, one gap apart, so none start blocked
+        int d = static_cast<int>(direction);
+        float back = (perLane[laneSlot]++ + 1) * (MIN_VEHICLE_GAP + 10.0f);
+        Vec2 spawn = SPAWN_POINTS[d][lane - 1];
+        Vec2 position = { spawn.x - DIRECTION_X[d] * back, spawn.y - DIRECTION_Y[d] * back };
+
+        SimVehicle vehicle = makeVehicle(direction, VehicleType::REGULAR, position, 30.0f);
+        vehicle.lane = static_cast<std::uint8_t>(lane);
+        addVehicle(vehicle);
+    }
+}
+
+SimVehicle IntersectionSim::makeVehicle(Direction direction, VehicleType type, Vec2 position, float speed) {
+    SimVehicle vehicle;
+    vehicle.plateNumber = plateIds.idAt(config.plateOffset + platesIssued++ * config.plateStride);
+    vehicle.position = position;
+    vehicle.direction = direction;
+    vehicle.type = type;
+    vehicle.lane = (type == VehicleType::HEAVY) ? 2 : 1; // Heavy vehicles use lane 2
+    vehicle.speed = speed;
+    vehicle.mockSpeed = generateMockSpeed(type, rng.get(RandomStream::SPEED));
+    stats.vehiclesSpawned++;
+    counts.queued[static_cast<int>(direction)][static_cast<int>(type)]++;
+    logVehicleSpawned(vehicle.plateNumber, direction, type, elapsedTime);
+    return vehicle;
+}
+
+// Put a vehicle on the road at the back of its lane
+void IntersectionSim::addVehicle(const SimVehicle& vehicle) {
+    size_t i = vehicles.push(vehicle);
+    lanes[laneIndex(vehicle.direction, vehicle.lane)].push_back(i);
+
+    int direction = static_cast<int>(vehicle.direction), type = static_cast<int>(vehicle.type);
+    counts.queued[direction][type]--;
+    counts.approaching[direction][type]++;
+}
+
+void IntersectionSim::spawnVehicles() {
+    bool northEmergency, southEmergency, eastEmergency, westEmergency;
+    northEmergency = southEmergency = eastEmergency = westEmergency = false;
+    Xoshiro256& spawnRandom = rng.get(RandomStream::SPAWN);
+
+    // Spawn emergency vehicles
+    // Max speed = 80km/hr
+    if (config.spawnFrom[static_cast<int>(Direction::NORTH)] && northEmergencyTimer >= 15.0f && spawnRandom.nextDouble() < 0.2) {
+        northQueue.push(makeVehicle(Direction::NORTH, VehicleType::EMERGENCY, NORTH_SPAWN_REGULAR_LANE1, 30.0f));
+        northEmergency = true;
+        northEmergencyTimer = 0.0f;
+    }
+
+    if (config.spawnFrom[static_cast<int>(Direction::SOUTH)] && southEmergencyTimer >= 6.0f && spawnRandom.nextDouble() < 0.05) {
+        southQueue.push(makeVehicle(Direction::SOUTH, VehicleType::EMERGENCY, SOUTH_SPAWN_REGULAR_LANE1, 30.0f));
+        southEmergency = true;
+        southEmergencyTimer = 0.0f;
+    }
+
+    if (config.spawnFrom[static_cast<int>(Direction::EAST)] && eastEmergencyTimer >= 20.0f && spawnRandom.nextDouble() < 0.1) {
+        eastQueue.push(makeVehicle(Direction::EAST, VehicleType::EMERGENCY, EAST_SPAWN_REGULAR_LANE1, 30.0f));
+        eastEmergency = true;
+        eastEmergencyTimer = 0.0f;
+    }
+
+    if (config.spawnFrom[static_cast<int>(Direction::WEST)] && westEmergencyTimer >= 6.0f && spawnRandom.nextDouble() < 0.3) {
+        westQueue.push(makeVehicle(Direction::WEST, VehicleType::EMERGENCY, WEST_SPAWN_REGULAR_LANE1, 30.0f));
+        westEmergency = true;
+        westEmergencyTimer = 0.0f;
+    }
+
+    // Spawn regular vehicles from each direction at their respective intervals
+    if (northTimer >= 3.0f && !northEmergency && config.spawnFrom[static_cast<int>(Direction::NORTH)]) {
+        northQueue.push(makeVehicle(Direction::NORTH, VehicleType::REGULAR, NORTH_SPAWN_REGULAR_LANE1, 30.0f));
+        northTimer = 0.0f;
+    }
+
+    if (southTimer >= 4.0f && !southEmergency && config.spawnFrom[static_cast<int>(Direction::SOUTH)]) {
+        southQueue.push(makeVehicle(Direction::SOUTH, VehicleType::REGULAR, SOUTH_SPAWN_REGULAR_LANE1, 30.0f));
+        southTimer = 0.0f;
+    }
+
+    if (eastTimer >= 3.5f && !eastEmergency && config.spawnFrom[static_cast<int>(Direction::EAST)]) {
+        eastQueue.push(makeVehicle(Direction::EAST, VehicleType::REGULAR, EAST_SPAWN_REGULAR_LANE1, 30.0f));
+        eastTimer = 0.0f;
+    }
+
+    if (westTimer >= 4.0f && !westEmergency && config.spawnFrom[static_cast<int>(Direction::WEST)]) {
+        westQueue.push(makeVehicle(Direction::WEST, VehicleType::REGULAR, WEST_SPAWN_REGULAR_LANE1, 30.0f));
+        westTimer = 0.0f;
+    }
+}
+
+void IntersectionSim::takeDepartures(std::vector<Departure>& out) {
+    out.insert(out.end(), departures.begin(), departures.end());
+    departures.clear();
+}
+
+void IntersectionSim::scheduleArrival(const SimVehicle& vehicle, double arrivalTime) {
+    pendingArrivals.push({ arrivalTime, arrivalSequence++, vehicle });
+}
+
+size_t IntersectionSim::getPendingArrivalCount() const {
+    return pendingArrivals.size();
+}
+
+// Vehicles handed over from a neighbour join the back of the spawn queue for their approach
+void IntersectionSim::receiveArrivals() {
+    std::queue<SimVehicle>* queues[DIRECTION_COUNT] = { &northQueue, &southQueue, &eastQueue, &westQueue };
+    while (!pendingArrivals.empty() && pendingArrivals.top().time <= elapsedTime) {
+        SimVehicle vehicle = pendingArrivals.top().vehicle;
+        pendingArrivals.pop();
+
+        int direction = static_cast<int>(vehicle.direction);
+        vehicle.lane = (vehicle.type == VehicleType::HEAVY) ? 2 : 1;
+        vehicle.position = SPAWN_POINTS[direction][vehicle.lane - 1];
+        queues[direction]->push(vehicle);
+        counts.queued[direction][static_cast<int>(vehicle.type)]++;
+        stats.vehiclesArrived++;
+    }
+}
+
+void IntersectionSim::admitVehicles() {
+    int northCount = counts.total(counts.approaching, Direction::NORTH);
+    int southCount = counts.total(counts.approaching, Direction::SOUTH);
+    int eastCount = counts.total(counts.approaching, Direction::EAST);
+    int westCount = counts.total(counts.approaching, Direction::WEST);
+
+    if (northCount <= 6 && !northQueue.empty()) {
+        addVehicle(northQueue.front());
+        northQueue.pop();
+    }
+
+    if (southCount <= 6 && !southQueue.empty()) {
+        addVehicle(southQueue.front());
+        southQueue.pop();
+    }
+
+    if (eastCount <= 5 && !eastQueue.empty()) {
+        addVehicle(eastQueue.front());
+        eastQueue.pop();
+    }
+
+    if (westCount <= 5 && !westQueue.empty()) {
+        addVehicle(westQueue.front());
+        westQueue.pop();
+    }
+}
+
+void IntersectionSim::spawnHeavyVehicles() {
+    // spawn heavy cars only during minute 2-3. For one minute
+    if (elapsedTime >= 120 && elapsedTime <= 180)
+    {// Spawn heavy cars
+        if (heavyCarTimer >= 15.0f) {
+            for (int d = 0; d < DIRECTION_COUNT; ++d) {
+                if (config.spawnFrom[d]) {
+                    addVehicle(makeVehicle(static_cast<Direction>(d), VehicleType::HEAVY, SPAWN_POINTS[d][1], 45.0f));
+                }
+            }
+            heavyCarTimer = 0.0f;
+        }
+    }
+    else
+    {
+        heavyCarTimer = 0.0f;
+    }
+}
+
+// Feed the signal controller: everything still to cross the stop line per approach, and
+// whether anything is sitting on the detector just before the line
+void IntersectionSim::measureDemand() {
+    const std::queue<SimVehicle>* queues[DIRECTION_COUNT] = { &northQueue, &southQueue, &eastQueue, &westQueue };
+    for (int d = 0; d < DIRECTION_COUNT; ++d) {
+        Direction direction = static_cast<Direction>(d);
+        demand.waiting[d] = static_cast<int>(queues[d]->size()) + counts.total(counts.approaching, direction);
+        demand.detected[d] = false;
+        for (int lane = 1; lane <= 2 && !demand.detected[d]; ++lane) {
+            for (size_t i : lanes[laneIndex(direction, static_cast<std::uint8_t>(lane))]) {
+                float progress = progressAlong(i);
+                if (progress >= STOP_LINE[d] - DETECTOR_LENGTH && progress <= TURN_LINE[d]) {
+                    demand.detected[d] = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// I have updated the mock speed when the vehicle hasnt crossed the traffic lights
+void IntersectionSim::updateSpeeds() {
+    if (speedTimer >= 5.0f) {
+        // Increase the mock speed of all vehicles
+        for (size_t i = 0; i < vehicles.size(); ++i) {
+            if (!(vehicles.flags[i] & FLAG_TURNED))
+                vehicles.mockSpeed[i] += 5;
+        }
+        speedTimer = 0.0f; // Reset the timer
+    }
+}
+
+// Check for speed violations
+void IntersectionSim::detectViolations() {
+    for (size_t i = 0; i < vehicles.size(); ++i) {
+        if (vehicles.flags[i] & FLAG_TURNED) {
+            continue;
+        }
+
+        // Check if the vehicle exceeds the speed limit for its type
+        if (vehicles.mockSpeed[i] > SPEED_LIMITS[static_cast<int>(vehicles.type[i])]) {
+            SpeedViolation violation = {
+                vehicles.plate[i],                          // Vehicle ID
+                vehicles.type[i],                           // vehicle type
+                static_cast<float>(vehicles.mockSpeed[i]),  // Current speed
+                vehicles.direction[i],                      // Direction of travel
+                ChallanStatus::ACTIVE
+            };
+            stats.violations++;
+            vehicles.mockSpeed[i] = 0;
+
+            if (violationHandler) {
+                violationHandler(violation);
+            }
+        }
+    }
+}
+
+// Reposition a vehicle onto the exit lane for its new direction. Heavy vehicles always use
+// lane 2, other vehicles pick a random lane except while the heavy vehicles are running.
+void IntersectionSim::turnVehicle(size_t i, Direction newDirection) {
+    int exit = static_cast<int>(newDirection);
+    Vec2 position;
+    if (vehicles.type[i] == VehicleType::HEAVY) {
+        position = EXIT_LANE2[exit];
+    } else if (elapsedTime < 120 || elapsedTime > 180) {
+        int decide = rng.get(RandomStream::TURN).nextBelow(2);
+        position = (decide == 0) ? EXIT_LANE1[exit] : EXIT_LANE2[exit];
+    } else {
+        position = EXIT_LANE1[exit];
+    }
+
+    int type = static_cast<int>(vehicles.type[i]);
+    counts.approaching[static_cast<int>(vehicles.direction[i])][type]--;
+    counts.departing[exit][type]++;
+
+    vehicles.posX[i] = position.x;
+    vehicles.posY[i] = position.y;
+    vehicles.direction[i] = newDirection;
+    vehicles.flags[i] |= FLAG_TURNED;
+}
+
+// Distance travelled along the vehicle's approach, ahead is always the larger value
+float IntersectionSim::progressAlong(size_t i) const {
+    int direction = static_cast<int>(vehicles.direction[i]);
+    return vehicles.posX[i] * DIRECTION_X[direction] + vehicles.posY[i] * DIRECTION_Y[direction];
+}
+
+// Keep a lane ordered front to back. Vehicles in a lane can't overtake, so it is almost
+// always sorted already and the insertion sort is linear.
+void IntersectionSim::sortLane(std::vector<size_t>& lane) {
+    for (size_t k = 1; k < lane.size(); ++k) {
+        size_t index = lane[k];
+        float progress = progressAlong(index);
+        size_t m = k;
+        while (m > 0 && progressAlong(lane[m - 1]) < progress) {
+            lane[m] = lane[m - 1];
+            --m;
+        }
+        lane[m] = index;
+    }
+}
+
+void IntersectionSim::moveVehicles(float dt) {
+    // Turned vehicles always move, approaching vehicles are decided lane by lane below
+    moveMask.assign(vehicles.size(), 1);
+    int stopped = 0;
+
+    for (auto& lane : lanes) {
+        sortLane(lane);
+
+        size_t kept = 0;
+        for (size_t k = 0; k < lane.size(); ++k) {
+            size_t i = lane[k];
+            int direction = static_cast<int>(vehicles.direction[i]);
+            float progress = progressAlong(i);
+
+            // Implement turning logic after crossnig signal
+            if (progress > TURN_LINE[direction]) {
+                int turn = rng.get(RandomStream::TURN).nextBelow(3); // 0 = LEFT, 1 = STRAIGHT, 2 = RIGHT
+                turnVehicle(i, TURN_TABLE[direction][turn]);
+                moveMask[i] = 0; // Skip moving this car in the current step
+                continue;        // and drop it from the lane
+            }
+
+            bool canMove = true;
+
+            // Check traffic light states
+            if (!signals.canPass(vehicles.direction[i]) && progress >= STOP_LINE[direction]) {
+                canMove = false; // Stop if at the traffic light
+            }
+
+            // The vehicle ahead is the nearest earlier lane entry that is strictly further along
+            size_t ahead = kept;
+            while (ahead > 0 && progressAlong(lane[ahead - 1]) <= progress) {
+                --ahead;
+            }
+            bool hasLeader = ahead > 0;
+            if (hasLeader && progressAlong(lane[ahead - 1]) - progress < MIN_VEHICLE_GAP) {
+                canMove = false; // Minimum gap
+            }
+
+            // An emergency vehicle at the top of its lane may run the light
+            if (vehicles.type[i] == VehicleType::EMERGENCY && !hasLeader) {
+                canMove = true;
+            }
+
+            moveMask[i] = canMove ? 1 : 0;
+            stopped += canMove ? 0 : 1;
+            lane[kept++] = i;
+        }
+        lane.resize(kept);
+    }
+
+    stats.totalDelay += dt * (stopped + counts.total(counts.queued));
+
+    // Move the vehicles that are allowed to, in one vectorised pass
+    integrateVehicles(vehicles.posX.data(), vehicles.posY.data(), vehicles.speed.data(), vehicles.direction.data(),
+                      moveMask.data(), vehicles.size(), dt);
+}
+
+// Remove vehicles that have turned and left the screen
+void IntersectionSim::despawnVehicles() {
+    size_t i = 0;
+    while (i < vehicles.size()) {
+        float x = vehicles.posX[i], y = vehicles.posY[i];
+        bool offScreen = x < -DESPAWN_MARGIN || x > SCREEN_SIZE + DESPAWN_MARGIN ||
+                         y < -DESPAWN_MARGIN || y > SCREEN_SIZE + DESPAWN_MARGIN;
+        if (vehicles.hasTurned(i) && offScreen) {
+            counts.departing[static_cast<int>(vehicles.direction[i])][static_cast<int>(vehicles.type[i])]--;
+            if (config.keepDepartures) {
+                departures.push_back({ vehicles.get(i), elapsedTime });
+            }
+
+            // Move the last vehicle into this slot, the removed one's storage gets reused
+            size_t last = vehicles.size() - 1;
+            vehicles.swapRemove(i);
+            // Only approaching vehicles are in a lane list and need their index updated
+            if (i != last && !vehicles.hasTurned(i)) {
+                std::vector<size_t>& lane = lanes[laneIndex(vehicles.direction[i], vehicles.lane[i])];
+                *std::find(lane.begin(), lane.end(), last) = i;
+            }
+            stats.vehiclesCleared++;
+        } else {
+            ++i;
+        }
+    }
+}
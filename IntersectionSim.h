@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+#include "IdAllocator.h"
+#include "Profiler.h"
+#include "Random.h"
+#include "SignalController.h"
+#include "VehicleStore.h"
+
+// Struct to represent a speed violation
+struct SpeedViolation {
+    PlateNumber vehicleID;
+    VehicleType type;
+    float speed;
+    Direction direction;
+    ChallanStatus status; // ACTIVE or INACTIVE
+};
+
+struct SimConfig {
+    float duration = 500.0f;     // Simulated seconds before the run is complete
+    float cycleDuration = 25.0f; // Total duration for one complete signal cycle
+    float yellowDuration = 4.0f;
+    SignalControl signalControl = SignalControl::FIXED_TIME;
+    std::shared_ptr<const SignalPlan> signalPlan; // Plan for FIXED_TIME (ACTUATED warns and ignores it), null builds the two-phase plan from the durations above
+    unsigned int seed = 0;       // Same seed and timestep give an identical run, 0 picks a random seed
+
+    // Approaches that generate their own traffic. In a network, approaches fed by a
+    // neighbouring intersection are switched off and only receive arrivals.
+    bool spawnFrom[DIRECTION_COUNT] = { true, true, true, true };
+    bool keepDepartures = false; // Hold vehicles that leave the screen for takeDepartures
+
+    // Plates are allocations plateOffset, plateOffset + plateStride, ... of the sequence keyed
+    // by plateKey (0 keys it from the seed). A network gives every intersection the same key
+    // and its own offset, so plates stay unique when vehicles are handed over.
+    std::uint64_t plateKey = 0;
+    std::uint32_t plateStride = 1;
+    std::uint32_t plateOffset = 0;
+};
+
+// A vehicle that left the screen, with the sim time it left at
+struct Departure {
+    SimVehicle vehicle; // direction is the direction it left in
+    double time;
+};
+
+struct SimStats {
+    int vehiclesSpawned = 0;
+    int vehiclesCleared = 0; // Vehicles that turned and drove off-screen
+    int vehiclesArrived = 0; // Vehicles handed over from another intersection
+    int violations = 0;
+    std::uint64_t vehicleSteps = 0; // Active vehicles summed over every step
+    double totalDelay = 0.0; // Vehicle-seconds spent queued to enter or stopped before the stop line
+};
+
+// Vehicles in each stage of their trip, indexed [direction][type]. Kept up to date as vehicles
+// spawn, are admitted, turn and despawn, so reading a count never walks the vehicles.
+struct VehicleCounts {
+    int queued[DIRECTION_COUNT][VEHICLE_TYPE_COUNT] = {};      // Spawned, waiting to enter the road
+    int approaching[DIRECTION_COUNT][VEHICLE_TYPE_COUNT] = {}; // On the road, not turned yet
+    int departing[DIRECTION_COUNT][VEHICLE_TYPE_COUNT] = {};   // Turned, by exit direction, until they leave the screen
+
+    // All types in one direction
+    int total(const int (&stage)[DIRECTION_COUNT][VEHICLE_TYPE_COUNT], Direction direction) const {
+        const int* row = stage[static_cast<int>(direction)];
+        return row[0] + row[1] + row[2];
+    }
+
+    // Everything in the stage
+    int total(const int (&stage)[DIRECTION_COUNT][VEHICLE_TYPE_COUNT]) const {
+        int sum = 0;
+        for (int d = 0; d < DIRECTION_COUNT; ++d) {
+            sum += total(stage, static_cast<Direction>(d));
+        }
+        return sum;
+    }
+};
+
+// Headless intersection engine. Everything advances through step(dt) only, so the
+// same engine can be driven by the SFML viewer or by a plain loop with no window.
+class IntersectionSim {
+public:
+    explicit IntersectionSim(const SimConfig& config = SimConfig());
+
+    void step(float dt);
+    bool isFinished() const;
+
+    double getElapsedTime() const;
+    const VehicleStore& getVehicles() const;
+    const SignalState& getSignals() const;
+    const SimStats& getStats() const;
+    const VehicleCounts& getVehicleCounts() const;
+    double getThroughputPerMinute() const;
+    double getAverageDelay() const; // Seconds per spawned vehicle
+
+    // Replace the controller picked from config.signalControl
+    void setSignalController(std::unique_ptr<SignalController> controller);
+    const SignalController& getSignalController() const;
+
+    // Called for every detected violation (from inside step)
+    void setViolationHandler(std::function<void(const SpeedViolation&)> handler);
+
+    // Time every stage of step() into profiler (not owned, null turns timing off)
+    void setProfiler(StageProfiler* profiler);
+
+    // Put count extra regular vehicles straight onto the road, spread over all 8 approach lanes
+    // and queued back from the spawn points. Admission limits don't apply, this is for
+    // benchmarks and high-density stress runs.
+    void populate(size_t count);
+
+    // Network hand-over. takeDepartures moves out every vehicle that has left since the last
+    // call (only kept with config.keepDepartures). scheduleArrival queues a vehicle on the
+    // approach it is travelling in, once the sim reaches arrivalTime.
+    void takeDepartures(std::vector<Departure>& out);
+    void scheduleArrival(const SimVehicle& vehicle, double arrivalTime);
+    size_t getPendingArrivalCount() const;
+
+private:
+    void spawnVehicles();
+    void receiveArrivals();
+    void admitVehicles();
+    void spawnHeavyVehicles();
+    void measureDemand();
+    void updateSpeeds();
+    void detectViolations();
+    void moveVehicles(float dt);
+    void despawnVehicles();
+    void addVehicle(const SimVehicle& vehicle);
+    void sortLane(std::vector<size_t>& lane);
+    void turnVehicle(size_t i, Direction newDirection);
+    SimVehicle makeVehicle(Direction direction, VehicleType type, Vec2 position, float speed);
+    float progressAlong(size_t i) const;
+
+    SimConfig config;
+    SimStats stats;
+    VehicleCounts counts;
+    SignalState signals;
+    std::unique_ptr<SignalController> signalController;
+    ApproachDemand demand;
+    std::function<void(const SpeedViolation&)> violationHandler;
+    StageProfiler* profiler = nullptr;
+
+    // Queues for each direction
+    std::queue<SimVehicle> northQueue, southQueue, eastQueue, westQueue;
+
+    // Vehicles on their way from another intersection, earliest first (ties in schedule order)
+    struct PendingArrival {
+        double time;
+        std::uint64_t sequence;
+        SimVehicle vehicle;
+        bool operator>(const PendingArrival& other) const {
+            return time != other.time ? time > other.time : sequence > other.sequence;
+        }
+    };
+    std::priority_queue<PendingArrival, std::vector<PendingArrival>, std::greater<PendingArrival>> pendingArrivals;
+    std::uint64_t arrivalSequence = 0;
+    std::vector<Departure> departures;
+
+    // Vehicles on the road. Finished vehicles are swap-removed, so the store's arrays are
+    // reused as a slot pool and only ever hold what is on screen.
+    VehicleStore vehicles;
+
+    // Indices into vehicles for every approach lane (NORTH, SOUTH, EAST, WEST x lane 1/lane 2),
+    // ordered front to back so the vehicle ahead is always the previous entry. Vehicles leave
+    // their lane when they turn.
+    static const int LANE_COUNT = 8;
+    std::vector<size_t> lanes[LANE_COUNT];
+    std::vector<std::uint8_t> moveMask; // Per-vehicle "may move this step", reused between steps
+
+    // Simulated timers (seconds), these replace the sf::Clocks the loop used to read.
+    // elapsedTime is a double so long runs don't lose precision adding small steps.
+    double elapsedTime = 0.0;
+    float northTimer = 0.0f, southTimer = 0.0f, eastTimer = 0.0f, westTimer = 0.0f, heavyCarTimer = 0.0f;
+    float northEmergencyTimer = 0.0f, southEmergencyTimer = 0.0f, eastEmergencyTimer = 0.0f, westEmergencyTimer = 0.0f;
+    float speedTimer = 0.0f;
+
+    // Spawn chances, turns, mock speeds and plates each draw from their own stream (seeded from config.seed)
+    RandomStreams rng;
+    IdAllocator plateIds; // Keyed from the ID stream unless config.plateKey is set
+    std::uint64_t platesIssued = 0;
+};
+
+int generateMockSpeed(VehicleType type, Xoshiro256& gen);
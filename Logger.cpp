@@ -0,0 +1,270 @@
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include "MpscRing.h"
+
+namespace {
+
+struct LogRecord {
+    enum Kind : std::uint8_t { MESSAGE, VEHICLE_SPAWNED, VIOLATION, CHALLAN_ISSUED };
+
+    Kind kind;
+    LogLevel level;
+    Direction direction;
+    VehicleType type;
+    ChallanStatus status;
+    PlateNumber plate;
+    ChallanNumber challanID;
+    float value;               // Speed for violations, amount for challans
+    double simTime;            // Simulated seconds, -1 when not from the simulation
+    std::int64_t wallTime;     // Microseconds since the epoch
+    std::int64_t dueTime;      // Epoch seconds, challans only
+    char text[192];            // Messages only, NUL terminated
+};
+
+const size_t LOG_RING_CAPACITY = 8192;
+const std::chrono::milliseconds DRAIN_IDLE_SLEEP(2);
+
+MpscRing<LogRecord> logRing(LOG_RING_CAPACITY);
+std::atomic<LogLevel> currentLevel{LogLevel::INFO};
+std::atomic<bool> eventsEnabled{false};
+std::atomic<bool> draining{false};
+std::ofstream eventFile;
+std::thread drainThread;
+
+const char* LEVEL_NAMES[] = { "DEBUG", "INFO", "WARN", "ERROR", "OFF" };
+
+std::int64_t wallMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+LogRecord makeRecord(LogRecord::Kind kind, LogLevel level) {
+    LogRecord record;
+    record.kind = kind;
+    record.level = level;
+    record.direction = Direction::NORTH;
+    record.type = VehicleType::REGULAR;
+    record.status = ChallanStatus::INACTIVE;
+    record.plate = 0;
+    record.challanID = 0;
+    record.value = 0.0f;
+    record.simTime = -1.0;
+    record.wallTime = wallMicros();
+    record.dueTime = 0;
+    record.text[0] = '\0';
+    return record;
+}
+
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        switch (*c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                    out << escaped;
+                } else {
+                    out << *c;
+                }
+        }
+    }
+    out << '"';
+}
+
+// One JSON object per line
+void writeEvent(const LogRecord& record) {
+    eventFile << "{\"time_us\":" << record.wallTime;
+    if (record.simTime >= 0.0) {
+        eventFile << ",\"sim_time\":" << record.simTime;
+    }
+    switch (record.kind) {
+        case LogRecord::MESSAGE:
+            eventFile << ",\"event\":\"log\",\"level\":\"" << LEVEL_NAMES[static_cast<int>(record.level)] << "\",\"message\":";
+            writeJsonString(eventFile, record.text);
+            break;
+        case LogRecord::VEHICLE_SPAWNED:
+            eventFile << ",\"event\":\"vehicle_spawned\",\"plate\":\"" << formatPlate(record.plate)
+                      << "\",\"direction\":\"" << toString(record.direction)
+                      << "\",\"type\":\"" << typeCode(record.type) << '"';
+            break;
+        case LogRecord::VIOLATION:
+            eventFile << ",\"event\":\"violation\",\"plate\":\"" << formatPlate(record.plate)
+                      << "\",\"direction\":\"" << toString(record.direction)
+                      << "\",\"type\":\"" << typeCode(record.type)
+                      << "\",\"speed\":" << record.value;
+            break;
+        case LogRecord::CHALLAN_ISSUED:
+            eventFile << ",\"event\":\"challan_issued\",\"challan\":\"" << formatChallanNumber(record.challanID)
+                      << "\",\"plate\":\"" << formatPlate(record.plate)
+                      << "\",\"status\":\"" << toString(record.status)
+                      << "\",\"amount\":" << record.value
+                      << ",\"due\":" << record.dueTime;
+            break;
+    }
+    eventFile << "}\n";
+}
+
+void handleRecord(const LogRecord& record) {
+    // Messages were checked against the level when they were logged
+    if (record.kind == LogRecord::MESSAGE) {
+        std::ostream& console = record.level >= LogLevel::WARN ? std::cerr : std::cout;
+        console << '[' << LEVEL_NAMES[static_cast<int>(record.level)] << "] " << record.text << '\n';
+    }
+    if (eventFile.is_open()) {
+        writeEvent(record);
+    }
+}
+
+void drainLoop() {
+    LogRecord record;
+    while (true) {
+        bool stopping = !draining.load(std::memory_order_acquire);
+        bool any = false;
+        while (logRing.pop(record)) {
+            handleRecord(record);
+            any = true;
+        }
+        if (any) {
+            std::cout.flush();
+            if (eventFile.is_open()) {
+                eventFile.flush();
+            }
+        } else if (stopping) {
+            break;
+        } else {
+            std::this_thread::sleep_for(DRAIN_IDLE_SLEEP);
+        }
+    }
+}
+
+} // namespace
+
+bool startLogger(LogLevel level, const std::string& eventPath) {
+    currentLevel.store(level);
+    if (!eventPath.empty()) {
+        eventFile.open(eventPath, std::ios::out | std::ios::app);
+        if (!eventFile.is_open()) {
+            std::cerr << "Error: Could not open event log " << eventPath << std::endl;
+            return false;
+        }
+        eventsEnabled.store(true);
+    }
+    draining.store(true, std::memory_order_release);
+    drainThread = std::thread(drainLoop);
+    return true;
+}
+
+void stopLogger() {
+    if (!drainThread.joinable()) {
+        return;
+    }
+    draining.store(false, std::memory_order_release);
+    drainThread.join();
+    eventsEnabled.store(false);
+    if (eventFile.is_open()) {
+        eventFile.close();
+    }
+    size_t dropped = logRing.getOverflowCount();
+    if (dropped > 0) {
+        std::cerr << "Logger dropped " << dropped << " records" << std::endl;
+    }
+}
+
+void setLogLevel(LogLevel level) {
+    currentLevel.store(level, std::memory_order_relaxed);
+}
+
+LogLevel getLogLevel() {
+    return currentLevel.load(std::memory_order_relaxed);
+}
+
+bool parseLogLevel(const std::string& text, LogLevel& level) {
+    for (int i = 0; i <= static_cast<int>(LogLevel::OFF); ++i) {
+        std::string name = LEVEL_NAMES[i];
+        if (text.size() == name.size() && std::equal(text.begin(), text.end(), name.begin(),
+                [](char a, char b) { return std::toupper(static_cast<unsigned char>(a)) == b; })) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isLogEnabled(LogLevel level) {
+    return level >= currentLevel.load(std::memory_order_relaxed);
+}
+
+bool isEventLogEnabled() {
+    return eventsEnabled.load(std::memory_order_relaxed);
+}
+
+void logMessage(LogLevel level, const std::string& text) {
+    if (!isLogEnabled(level)) {
+        return;
+    }
+    LogRecord record = makeRecord(LogRecord::MESSAGE, level);
+    size_t length = std::min(text.size(), sizeof(record.text) - 1);
+    std::memcpy(record.text, text.data(), length);
+    record.text[length] = '\0';
+    logRing.push(record);
+}
+
+void logError(const std::string& text) {
+    logMessage(LogLevel::ERROR, text);
+}
+
+void logVehicleSpawned(PlateNumber plate, Direction direction, VehicleType type, double simTime) {
+    if (!isEventLogEnabled()) {
+        return;
+    }
+    LogRecord record = makeRecord(LogRecord::VEHICLE_SPAWNED, LogLevel::INFO);
+    record.plate = plate;
+    record.direction = direction;
+    record.type = type;
+    record.simTime = simTime;
+    logRing.push(record);
+}
+
+void logViolation(const SpeedViolation& violation, double simTime) {
+    if (!isEventLogEnabled()) {
+        return;
+    }
+    LogRecord record = makeRecord(LogRecord::VIOLATION, LogLevel::INFO);
+    record.plate = violation.vehicleID;
+    record.direction = violation.direction;
+    record.type = violation.type;
+    record.value = violation.speed;
+    record.simTime = simTime;
+    logRing.push(record);
+}
+
+void logChallanIssued(const Challan& challan) {
+    if (!isEventLogEnabled()) {
+        return;
+    }
+    LogRecord record = makeRecord(LogRecord::CHALLAN_ISSUED, LogLevel::INFO);
+    record.plate = challan.vehicleID;
+    record.challanID = challan.challanID;
+    record.status = challan.status;
+    record.value = challan.payableAmount;
+    record.dueTime = challan.dueTime;
+    logRing.push(record);
+}
+
+size_t getDroppedLogCount() {
+    return logRing.getOverflowCount();
+}
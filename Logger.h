@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "ChallanStore.h"
+#include "IntersectionSim.h"
+
+enum class LogLevel : std::uint8_t { DEBUG, INFO, WARN, ERROR, OFF };
+
+// Asynchronous logger. Callers only copy a fixed-size record into a lock-free ring (nothing is
+// formatted or written on their thread); a drain thread prints messages that passed the level
+// and appends them, plus the structured events, to a JSON-lines file. When the ring is full
+// records are dropped and counted rather than stalling the caller.
+
+// Start the drain thread. Structured events go to eventPath, or nowhere if it is empty.
+bool startLogger(LogLevel level, const std::string& eventPath);
+
+// Write out everything already logged and stop the drain thread
+void stopLogger();
+
+// Calls stopLogger when it goes out of scope, so every return after startLogger joins the
+// drain thread (a still-joinable thread at exit would terminate the process)
+struct LoggerGuard {
+    LoggerGuard() = default;
+    LoggerGuard(const LoggerGuard&) = delete;
+    LoggerGuard& operator=(const LoggerGuard&) = delete;
+    ~LoggerGuard() { stopLogger(); }
+};
+
+// The level can be changed at any time, from any thread
+void setLogLevel(LogLevel level);
+LogLevel getLogLevel();
+bool parseLogLevel(const std::string& text, LogLevel& level);
+
+// Cheap checks so callers can skip building a message nobody will see
+bool isLogEnabled(LogLevel level);
+bool isEventLogEnabled();
+
+// Free-text message, truncated to the record size
+void logMessage(LogLevel level, const std::string& text);
+void logError(const std::string& text);
+
+// Structured events
+void logVehicleSpawned(PlateNumber plate, Direction direction, VehicleType type, double simTime);
+void logViolation(const SpeedViolation& violation, double simTime);
+void logChallanIssued(const Challan& challan);
+
+// Records lost because the ring was full
+size_t getDroppedLogCount();
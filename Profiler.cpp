@@ -0,0 +1,90 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+const char* toString(Stage stage) {
+    static const char* NAMES[STAGE_COUNT] = {
+        "spawn", "admit", "signals", "violations", "move", "despawn", "step", "hud", "draw", "frame"
+    };
+    return NAMES[static_cast<int>(stage)];
+}
+
+StageProfiler::StageProfiler(size_t windowSize)
+    : windowSize(std::max<size_t>(windowSize, 1)) {
+    for (Window& window : windows) {
+        window.samples.resize(this->windowSize);
+    }
+}
+
+void StageProfiler::record(Stage stage, std::chrono::nanoseconds duration) {
+    Window& window = windows[static_cast<int>(stage)];
+    window.samples[window.next] = duration.count();
+    window.next = (window.next + 1) % windowSize;
+    window.count = std::min(window.count + 1, windowSize);
+}
+
+StageTiming StageProfiler::getTiming(Stage stage) const {
+    const Window& window = windows[static_cast<int>(stage)];
+    StageTiming timing;
+    timing.samples = window.count;
+    if (window.count == 0) {
+        return timing;
+    }
+
+    std::vector<std::int64_t> sorted(window.samples.begin(), window.samples.begin() + window.count);
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) {
+        size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[index] / 1000.0;
+    };
+    timing.p50 = percentile(0.50);
+    timing.p95 = percentile(0.95);
+    timing.p99 = percentile(0.99);
+
+    double total = 0.0;
+    for (std::int64_t sample : sorted) {
+        total += sample;
+    }
+    timing.mean = total / sorted.size() / 1000.0;
+    return timing;
+}
+
+std::chrono::nanoseconds StageProfiler::getLastDuration(Stage stage) const {
+    const Window& window = windows[static_cast<int>(stage)];
+    if (window.count == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    return std::chrono::nanoseconds(window.samples[(window.next + windowSize - 1) % windowSize]);
+}
+
+bool StageProfiler::writeCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error: Could not write " << path << std::endl;
+        return false;
+    }
+    file << "stage,samples,p50_us,p95_us,p99_us,mean_us\n";
+    for (int s = 0; s < STAGE_COUNT; ++s) {
+        StageTiming timing = getTiming(static_cast<Stage>(s));
+        file << toString(static_cast<Stage>(s)) << ',' << timing.samples << ',' << timing.p50 << ','
+             << timing.p95 << ',' << timing.p99 << ',' << timing.mean << '\n';
+    }
+    return true;
+}
+
+std::string StageProfiler::formatTable() const {
+    std::string table = "stage           p50      p95      p99  (us)\n";
+    char line[96];
+    for (int s = 0; s < STAGE_COUNT; ++s) {
+        StageTiming timing = getTiming(static_cast<Stage>(s));
+        if (timing.samples == 0) {
+            continue;
+        }
+        std::snprintf(line, sizeof(line), "%-10s %8.1f %8.1f %8.1f\n",
+                      toString(static_cast<Stage>(s)), timing.p50, timing.p95, timing.p99);
+        table += line;
+    }
+    return table;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Parts of a step / frame that get their own timer. Engine stages are timed once per step,
+// viewer stages once per frame.
+enum class Stage : std::uint8_t {
+    SPAWN,      // spawnVehicles
+    ADMIT,      // admitVehicles + spawnHeavyVehicles (everything that puts vehicles on the road)
+    SIGNALS,    // SignalController::update
+    VIOLATIONS, // updateSpeeds + detectViolations
+    MOVE,       // moveVehicles (lane order, leader checks, turns, integration)
+    DESPAWN,    // despawnVehicles
+    STEP,       // Every engine step run in one frame
+    HUD,        // HUD counters and text
+    DRAW,       // Building the sprite batch, drawing and display
+    FRAME       // Whole frame
+};
+
+const int STAGE_COUNT = 10;
+
+const char* toString(Stage stage);
+
+struct StageTiming {
+    size_t samples = 0;
+    double p50 = 0.0, p95 = 0.0, p99 = 0.0, mean = 0.0; // Microseconds
+};
+
+// Keeps the last windowSize durations of every stage and reports percentiles over them.
+// Recording is a store into a ring; percentiles are only worked out when asked for, so the
+// overlay can refresh a few times a second without costing every frame. Single-threaded.
+class StageProfiler {
+public:
+    explicit StageProfiler(size_t windowSize = 512);
+
+    void record(Stage stage, std::chrono::nanoseconds duration);
+    StageTiming getTiming(Stage stage) const;
+
+    // Most recent sample, zero if the stage hasn't run
+    std::chrono::nanoseconds getLastDuration(Stage stage) const;
+
+    // One row per stage: stage,samples,p50_us,p95_us,p99_us,mean_us
+    bool writeCsv(const std::string& path) const;
+
+    // Fixed-width table for the overlay and the headless summary
+    std::string formatTable() const;
+
+private:
+    struct Window {
+        std::vector<std::int64_t> samples; // Nanoseconds, used as a ring
+        size_t next = 0;
+        size_t count = 0;
+    };
+
+    size_t windowSize;
+    Window windows[STAGE_COUNT];
+};
+
+// Times its own lifetime into a stage. A null profiler turns it into a no-op without
+// reading the clock, so timers can stay in place when profiling is off.
+class ScopedStageTimer {
+public:
+    ScopedStageTimer(StageProfiler* profiler, Stage stage)
+        : profiler(profiler), stage(stage) {
+        if (profiler) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedStageTimer() {
+        if (profiler) {
+            profiler->record(stage, std::chrono::steady_clock::now() - start);
+        }
+    }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    StageProfiler* profiler;
+    Stage stage;
+    std::chrono::steady_clock::time_point start;
+};
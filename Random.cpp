@@ -0,0 +1,49 @@
+#include "Random.h"
+
+namespace {
+
+// SplitMix64, used to expand a 64-bit seed into xoshiro's state
+std::uint64_t splitMix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+Xoshiro256::Xoshiro256(std::uint64_t seed) {
+    for (std::uint64_t& word : state) {
+        word = splitMix64(seed);
+    }
+}
+
+void Xoshiro256::jump() {
+    static const std::uint64_t JUMP[] = {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+    };
+    std::uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (std::uint64_t word : JUMP) {
+        for (int bit = 0; bit < 64; ++bit) {
+            if (word & (std::uint64_t(1) << bit)) {
+                s0 ^= state[0];
+                s1 ^= state[1];
+                s2 ^= state[2];
+                s3 ^= state[3];
+            }
+            (*this)();
+        }
+    }
+    state[0] = s0;
+    state[1] = s1;
+    state[2] = s2;
+    state[3] = s3;
+}
+
+RandomStreams::RandomStreams(std::uint64_t seed) {
+    streams[0] = Xoshiro256(seed);
+    for (int i = 1; i < RANDOM_STREAM_COUNT; ++i) {
+        streams[i] = streams[i - 1];
+        streams[i].jump();
+    }
+}
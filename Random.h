@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+
+// xoshiro256** (Blackman & Vigna). A few nanoseconds per draw with 256 bits of state, and
+// jump() skips 2^128 draws so streams split from one seed never overlap. Meets the standard
+// UniformRandomBitGenerator requirements so <random> distributions work with it too.
+class Xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1)
+    double nextDouble() {
+        return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Uniform in [0, bound), bound > 0 (Lemire's multiply-shift, no modulo bias)
+    std::uint32_t nextBelow(std::uint32_t bound) {
+        std::uint64_t product = ((*this)() >> 32) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            std::uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = ((*this)() >> 32) * bound;
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+    // Advance 2^128 draws
+    void jump();
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t state[4];
+};
+
+// Independent named streams, so adding a draw to one part of the simulation (say an extra
+// turn decision) does not shift the numbers every other part sees.
+enum class RandomStream : std::uint8_t { SPAWN, TURN, SPEED, ID };
+
+const int RANDOM_STREAM_COUNT = 4;
+
+// One generator per stream, all derived from a single seed
+class RandomStreams {
+public:
+    explicit RandomStreams(std::uint64_t seed = 0);
+
+    Xoshiro256& get(RandomStream stream) {
+        return streams[static_cast<int>(stream)];
+    }
+
+private:
+    Xoshiro256 streams[RANDOM_STREAM_COUNT];
+};
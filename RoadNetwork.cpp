@@ -0,0 +1,187 @@
+#include "RoadNetwork.h"
+#include <algorithm>
+#include <random>
+
+// Grid offset (row, column) a vehicle moves by when it leaves in each Direction. NORTH
+// traffic moves down the screen, so it reaches the intersection in the next row.
+const int ROW_STEP[DIRECTION_COUNT] = { 1, -1, 0, 0 };
+const int COLUMN_STEP[DIRECTION_COUNT] = { 0, 0, -1, 1 };
+
+RoadNetwork::RoadNetwork(const NetworkConfig& config)
+    : config(config) {
+    this->config.rows = std::max(this->config.rows, 1);
+    this->config.columns = std::max(this->config.columns, 1);
+    int rows = this->config.rows, columns = this->config.columns;
+    size_t count = static_cast<size_t>(rows) * columns;
+
+    // An interval may not be longer than a segment, see the class comment
+    float interval = std::min(config.exchangeInterval, config.segmentTravelTime);
+    stepsPerInterval = std::max(1, static_cast<int>(interval / config.timestep + 1e-4f));
+
+    auto inGrid = [&](int row, int column) {
+        return row >= 0 && row < rows && column >= 0 && column < columns;
+    };
+
+    // One plate sequence for the whole grid, keyed the way intersection 0 would key its own
+    std::uint64_t plateKey = config.intersection.seed != 0
+        ? RandomStreams(config.intersection.seed).get(RandomStream::ID)()
+        : (static_cast<std::uint64_t>(std::random_device{}()) << 32 | std::random_device{}());
+
+    segmentFrom.assign(count * DIRECTION_COUNT, -1);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            size_t index = static_cast<size_t>(row) * columns + column;
+
+            SimConfig simConfig = config.intersection;
+            simConfig.seed = config.intersection.seed != 0 ? config.intersection.seed + static_cast<unsigned int>(index) : 0;
+            simConfig.keepDepartures = true;
+            simConfig.plateKey = plateKey;
+            simConfig.plateStride = static_cast<std::uint32_t>(count);
+            simConfig.plateOffset = static_cast<std::uint32_t>(index);
+            for (int d = 0; d < DIRECTION_COUNT; ++d) {
+                // Approach d is fed by the intersection its traffic comes from, one step back
+                bool fed = inGrid(row - ROW_STEP[d], column - COLUMN_STEP[d]);
+                simConfig.spawnFrom[d] = config.intersection.spawnFrom[d] && (!fed || config.interiorSpawns);
+
+                int nextRow = row + ROW_STEP[d], nextColumn = column + COLUMN_STEP[d];
+                if (inGrid(nextRow, nextColumn)) {
+                    segmentFrom[index * DIRECTION_COUNT + d] = static_cast<int>(segments.size());
+                    segments.push_back({ index, static_cast<size_t>(nextRow) * columns + nextColumn, static_cast<Direction>(d) });
+                }
+            }
+            intersections.push_back(std::make_unique<IntersectionSim>(simConfig));
+        }
+    }
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = config.threads > 0 ? config.threads : static_cast<int>(cores);
+    threadCount = std::max(1, std::min(threadCount, static_cast<int>(count)));
+    for (int w = 1; w < threadCount; ++w) {
+        workers.emplace_back(&RoadNetwork::workerLoop, this, static_cast<size_t>(w));
+    }
+}
+
+RoadNetwork::~RoadNetwork() {
+    {
+        std::lock_guard<std::mutex> lock(phaseMutex);
+        stopping = true;
+    }
+    phaseStart.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void RoadNetwork::advance() {
+    {
+        std::lock_guard<std::mutex> lock(phaseMutex);
+        ++phase;
+        workersBusy = threadCount - 1;
+    }
+    phaseStart.notify_all();
+    stepShare(0);
+    {
+        std::unique_lock<std::mutex> lock(phaseMutex);
+        phaseDone.wait(lock, [this] { return workersBusy == 0; });
+    }
+
+    // Boundary exchange, every intersection is idle until the next interval starts
+    exchange();
+    elapsedTime = intersections.front()->getElapsedTime();
+}
+
+void RoadNetwork::run() {
+    while (!isFinished()) {
+        advance();
+    }
+}
+
+bool RoadNetwork::isFinished() const {
+    return intersections.front()->isFinished();
+}
+
+// Each worker owns a fixed, contiguous run of intersections
+void RoadNetwork::stepShare(size_t worker) {
+    size_t count = intersections.size();
+    size_t begin = worker * count / threadCount, end = (worker + 1) * count / threadCount;
+    for (size_t i = begin; i < end; ++i) {
+        IntersectionSim& sim = *intersections[i];
+        for (int s = 0; s < stepsPerInterval && !sim.isFinished(); ++s) {
+            sim.step(config.timestep);
+        }
+    }
+}
+
+void RoadNetwork::workerLoop(size_t worker) {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(phaseMutex);
+            phaseStart.wait(lock, [&] { return phase != seen || stopping; });
+            if (stopping) {
+                return;
+            }
+            seen = phase;
+        }
+        stepShare(worker);
+        {
+            std::lock_guard<std::mutex> lock(phaseMutex);
+            if (--workersBusy == 0) {
+                phaseDone.notify_one();
+            }
+        }
+    }
+}
+
+// Runs on one thread in intersection order, so hand-overs are the same for any thread count
+void RoadNetwork::exchange() {
+    for (size_t i = 0; i < intersections.size(); ++i) {
+        departures.clear();
+        intersections[i]->takeDepartures(departures);
+        for (const Departure& departure : departures) {
+            int segment = segmentFrom[i * DIRECTION_COUNT + static_cast<int>(departure.vehicle.direction)];
+            if (segment < 0) {
+                vehiclesExited++; // Drove off the edge of the grid
+                continue;
+            }
+            RoadSegment& road = segments[segment];
+            road.vehiclesCarried++;
+            handOvers++;
+            intersections[road.to]->scheduleArrival(departure.vehicle, departure.time + config.segmentTravelTime);
+        }
+    }
+}
+
+double RoadNetwork::getElapsedTime() const {
+    return elapsedTime;
+}
+
+size_t RoadNetwork::getIntersectionCount() const {
+    return intersections.size();
+}
+
+const IntersectionSim& RoadNetwork::getIntersection(size_t index) const {
+    return *intersections[index];
+}
+
+const std::vector<RoadSegment>& RoadNetwork::getSegments() const {
+    return segments;
+}
+
+NetworkStats RoadNetwork::getStats() const {
+    NetworkStats stats;
+    for (const auto& sim : intersections) {
+        const SimStats& simStats = sim->getStats();
+        stats.vehiclesSpawned += simStats.vehiclesSpawned;
+        stats.violations += simStats.violations;
+        stats.totalDelay += simStats.totalDelay;
+        stats.inTransit += static_cast<int>(sim->getPendingArrivalCount());
+    }
+    stats.vehiclesExited = vehiclesExited;
+    stats.handOvers = handOvers;
+    return stats;
+}
+
+int RoadNetwork::getThreadCount() const {
+    return threadCount;
+}
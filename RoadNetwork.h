@@ -0,0 +1,89 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "IntersectionSim.h"
+
+struct NetworkConfig {
+    int rows = 1;
+    int columns = 2;
+    float segmentTravelTime = 8.0f; // Seconds from leaving one intersection to queueing at the next
+    float exchangeInterval = 0.5f;  // Sim seconds between hand-overs, capped at segmentTravelTime
+    float timestep = 1.0f / 60.0f;
+    int threads = 0;                // 0 uses one per core
+    bool interiorSpawns = false;    // Also generate traffic on approaches fed by a neighbour
+    SimConfig intersection;         // Every intersection runs this, seeded seed + its index
+};
+
+// Road from one intersection's exit to the approach of its neighbour
+struct RoadSegment {
+    size_t from;
+    size_t to;
+    Direction direction; // Direction of travel, also the approach it joins at the far end
+    int vehiclesCarried = 0;
+};
+
+struct NetworkStats {
+    int vehiclesSpawned = 0;   // Entered the network at an edge (or inside with interiorSpawns)
+    int vehiclesExited = 0;    // Left the network at an edge
+    int handOvers = 0;         // Crossed a road segment between intersections
+    int inTransit = 0;         // On a segment right now
+    int violations = 0;
+    double totalDelay = 0.0;   // Summed over every intersection
+
+    double getAverageDelay() const { return vehiclesSpawned > 0 ? totalDelay / vehiclesSpawned : 0.0; }
+};
+
+// Grid of intersections, row-major, linked by road segments. Each exchange interval the
+// intersections are stepped in parallel, independently of each other; then, on one thread
+// and in a fixed order, vehicles that left an intersection are handed to the next one with
+// an arrival time segmentTravelTime later. A segment always takes at least one interval to
+// cross, so nothing has to cross within an interval and the result doesn't depend on the
+// thread count.
+class RoadNetwork {
+public:
+    explicit RoadNetwork(const NetworkConfig& config);
+    ~RoadNetwork();
+
+    RoadNetwork(const RoadNetwork&) = delete;
+    RoadNetwork& operator=(const RoadNetwork&) = delete;
+
+    // Step every intersection through one exchange interval, then hand vehicles over
+    void advance();
+    void run();
+    bool isFinished() const;
+
+    double getElapsedTime() const;
+    size_t getIntersectionCount() const;
+    const IntersectionSim& getIntersection(size_t index) const;
+    const std::vector<RoadSegment>& getSegments() const;
+    NetworkStats getStats() const;
+    int getThreadCount() const;
+
+private:
+    void workerLoop(size_t worker);
+    void stepShare(size_t worker);
+    void exchange();
+
+    NetworkConfig config;
+    int stepsPerInterval;
+    std::vector<std::unique_ptr<IntersectionSim>> intersections;
+    std::vector<RoadSegment> segments;
+    std::vector<int> segmentFrom;  // [intersection * DIRECTION_COUNT + exit direction], -1 at the edge
+    std::vector<Departure> departures; // Reused between exchanges
+    int vehiclesExited = 0;
+    int handOvers = 0;
+    double elapsedTime = 0.0;
+
+    // Workers 1..n-1 are threads, the caller of advance() steps worker 0's share
+    int threadCount;
+    std::vector<std::thread> workers;
+    std::mutex phaseMutex;
+    std::condition_variable phaseStart, phaseDone;
+    std::uint64_t phase = 0;       // Bumped to start an interval
+    int workersBusy = 0;
+    bool stopping = false;
+};
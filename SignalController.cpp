@@ -0,0 +1,109 @@
+#include "SignalController.h"
+
+FixedTimeController::FixedTimeController(SignalPlan plan)
+    : plan(std::move(plan)) {
+}
+
+void FixedTimeController::update(float dt, const ApproachDemand&, SignalState& signals) {
+    cycleTime += dt;
+
+    // Phases only move forward within a cycle. Zero-length phases are stepped over, except
+    // that the last one is shown on the step where the cycle wraps.
+    while (phaseIndex + 1 < plan.getPhaseCount() && cycleTime >= plan.getPhaseEnd(phaseIndex)) {
+        ++phaseIndex;
+    }
+    signals.show(plan.getPhase(phaseIndex));
+
+    if (cycleTime >= plan.getCycleLength()) {
+        cycleTime = 0.0f; // Restart the cycle timer
+        phaseIndex = 0;
+    }
+}
+
+const char* FixedTimeController::getName() const {
+    return "fixed";
+}
+
+const SignalPlan& FixedTimeController::getPlan() const {
+    return plan;
+}
+
+size_t FixedTimeController::getPhaseIndex() const {
+    return phaseIndex;
+}
+
+ActuatedController::ActuatedController(const ActuatedTiming& timing)
+    : timing(timing) {
+}
+
+void ActuatedController::update(float dt, const ApproachDemand& demand, SignalState& signals) {
+    int n = static_cast<int>(Direction::NORTH), s = static_cast<int>(Direction::SOUTH);
+    int e = static_cast<int>(Direction::EAST), w = static_cast<int>(Direction::WEST);
+    bool servedDetected = northSouth ? (demand.detected[n] || demand.detected[s])
+                                     : (demand.detected[e] || demand.detected[w]);
+    bool otherWaiting = northSouth ? (demand.waiting[e] + demand.waiting[w] > 0)
+                                   : (demand.waiting[n] + demand.waiting[s] > 0);
+
+    intervalTime += dt;
+    switch (interval) {
+    case Interval::GREEN:
+        gapTime = servedDetected ? 0.0f : gapTime + dt;
+        if (otherWaiting && intervalTime >= timing.minGreen &&
+            (gapTime >= timing.passageTime || intervalTime >= timing.maxGreen)) {
+            interval = Interval::YELLOW;
+            intervalTime = 0.0f;
+        }
+        break;
+    case Interval::YELLOW:
+        if (intervalTime >= timing.yellow) {
+            interval = Interval::ALL_RED;
+            intervalTime = 0.0f;
+        }
+        break;
+    case Interval::ALL_RED:
+        if (intervalTime >= timing.allRed) {
+            northSouth = !northSouth;
+            interval = Interval::GREEN;
+            intervalTime = 0.0f;
+            gapTime = 0.0f;
+        }
+        break;
+    }
+    apply(signals);
+}
+
+void ActuatedController::apply(SignalState& signals) const {
+    LightColor served = interval == Interval::GREEN ? LightColor::GREEN
+                      : interval == Interval::YELLOW ? LightColor::YELLOW
+                      : LightColor::RED;
+    LightColor northSouthColor = northSouth ? served : LightColor::RED;
+    LightColor eastWestColor = northSouth ? LightColor::RED : served;
+    signals.approach[static_cast<int>(Direction::NORTH)] = northSouthColor;
+    signals.approach[static_cast<int>(Direction::SOUTH)] = northSouthColor;
+    signals.approach[static_cast<int>(Direction::EAST)] = eastWestColor;
+    signals.approach[static_cast<int>(Direction::WEST)] = eastWestColor;
+    signals.heads.assign(std::begin(signals.approach), std::end(signals.approach));
+}
+
+const char* ActuatedController::getName() const {
+    return "actuated";
+}
+
+bool parseSignalControl(const std::string& text, SignalControl& control) {
+    if (text == "fixed") {
+        control = SignalControl::FIXED_TIME;
+        return true;
+    }
+    if (text == "actuated") {
+        control = SignalControl::ACTUATED;
+        return true;
+    }
+    return false;
+}
+
+std::unique_ptr<SignalController> makeSignalController(SignalControl control, const SignalPlan& plan) {
+    if (control == SignalControl::ACTUATED) {
+        return std::make_unique<ActuatedController>();
+    }
+    return std::make_unique<FixedTimeController>(plan);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "SignalPlan.h"
+#include "VehicleStore.h"
+
+// Light colours for this step, written by the controller and read by the sim and the viewer
+struct SignalState {
+    std::vector<LightColor> heads;                // Every head of the plan, in plan order
+    LightColor approach[DIRECTION_COUNT] = {};    // What vehicles on each approach see (starts RED)
+
+    bool canPass(Direction direction) const {
+        return approach[static_cast<int>(direction)] == LightColor::GREEN;
+    }
+
+    void show(const SignalPhase& phase) {
+        heads = phase.heads;
+        std::copy(std::begin(phase.approach), std::end(phase.approach), std::begin(approach));
+    }
+};
+
+// What the detectors saw on each approach this step, indexed by Direction
+struct ApproachDemand {
+    int waiting[DIRECTION_COUNT] = {};    // Vehicles spawned or on the approach that haven't crossed the stop line
+    bool detected[DIRECTION_COUNT] = {};  // A vehicle is in the detection zone just before the stop line
+};
+
+// Decides the light states. Called once per step from IntersectionSim::step.
+class SignalController {
+public:
+    virtual ~SignalController() = default;
+
+    virtual void update(float dt, const ApproachDemand& demand, SignalState& signals) = 0;
+    virtual const char* getName() const = 0;
+};
+
+// Runs a SignalPlan's phases in order, ignoring demand. The current phase is kept and only
+// moves forward, so each step is a couple of comparisons however long the plan is.
+class FixedTimeController : public SignalController {
+public:
+    explicit FixedTimeController(SignalPlan plan);
+
+    void update(float dt, const ApproachDemand& demand, SignalState& signals) override;
+    const char* getName() const override;
+
+    const SignalPlan& getPlan() const;
+    size_t getPhaseIndex() const;
+
+private:
+    SignalPlan plan;
+    size_t phaseIndex = 0;
+    float cycleTime = 0.0f;
+};
+
+struct ActuatedTiming {
+    float minGreen = 6.0f;     // Green is never cut shorter than this
+    float maxGreen = 30.0f;    // Green is cut here if the other phase is waiting (max-out)
+    float passageTime = 2.5f;  // Green ends once the detectors have been empty this long (gap-out)
+    float yellow = 4.0f;
+    float allRed = 2.5f;
+};
+
+// Two-phase (N-S, E-W) actuated control with one head per approach. A green holds while
+// vehicles keep arriving on its detectors, ends early on a gap-out once the other phase has
+// demand, and is capped by maxGreen. With no demand anywhere it rests in the current green.
+class ActuatedController : public SignalController {
+public:
+    explicit ActuatedController(const ActuatedTiming& timing = ActuatedTiming());
+
+    void update(float dt, const ApproachDemand& demand, SignalState& signals) override;
+    const char* getName() const override;
+
+private:
+    enum class Interval { GREEN, YELLOW, ALL_RED };
+
+    void apply(SignalState& signals) const;
+
+    ActuatedTiming timing;
+    bool northSouth = true; // Phase being served
+    Interval interval = Interval::GREEN;
+    float intervalTime = 0.0f;
+    float gapTime = 0.0f;   // Time since the served phase's detectors last saw a vehicle
+};
+
+enum class SignalControl { FIXED_TIME, ACTUATED };
+
+// "fixed" or "actuated"
+bool parseSignalControl(const std::string& text, SignalControl& control);
+
+// FIXED_TIME runs plan, ACTUATED ignores it
+std::unique_ptr<SignalController> makeSignalController(SignalControl control, const SignalPlan& plan);
@@ -0,0 +1,180 @@
+#include "SignalPlan.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+const char* toString(LightColor color) {
+    switch (color) {
+        case LightColor::RED: return "RED";
+        case LightColor::YELLOW: return "YELLOW";
+        case LightColor::GREEN: return "GREEN";
+    }
+    return "RED";
+}
+
+static bool parseColor(const std::string& text, LightColor& color) {
+    if (text.size() != 1) {
+        return false;
+    }
+    switch (std::toupper(static_cast<unsigned char>(text[0]))) {
+        case 'R': color = LightColor::RED; return true;
+        case 'Y': color = LightColor::YELLOW; return true;
+        case 'G': color = LightColor::GREEN; return true;
+    }
+    return false;
+}
+
+static bool parseDirection(std::string text, Direction& direction) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::toupper(c); });
+    for (int d = 0; d < DIRECTION_COUNT; ++d) {
+        if (text == toString(static_cast<Direction>(d))) {
+            direction = static_cast<Direction>(d);
+            return true;
+        }
+    }
+    return false;
+}
+
+SignalPlan SignalPlan::makeFixedTime(float cycleDuration, float yellowDuration) {
+    const LightColor R = LightColor::RED, Y = LightColor::YELLOW, G = LightColor::GREEN;
+    float greenPhaseDuration = (cycleDuration / 2) - yellowDuration;
+    float allRedDuration = (cycleDuration / 2) - greenPhaseDuration - yellowDuration;
+
+    SignalPlan plan;
+    plan.addHead("north", Direction::NORTH);
+    plan.addHead("south", Direction::SOUTH);
+    plan.addHead("east", Direction::EAST);
+    plan.addHead("west", Direction::WEST);
+    plan.addPhase("NS_GREEN", greenPhaseDuration, { G, G, R, R });
+    plan.addPhase("NS_YELLOW", yellowDuration, { Y, Y, R, R });
+    plan.addPhase("NS_ALL_RED", allRedDuration, { R, R, R, R });
+    plan.addPhase("EW_GREEN", greenPhaseDuration, { R, R, G, G });
+    plan.addPhase("EW_YELLOW", yellowDuration, { R, R, Y, Y });
+    plan.addPhase("EW_ALL_RED", allRedDuration, { R, R, R, R });
+    return plan;
+}
+
+bool SignalPlan::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error: Could not open signal plan " << path << std::endl;
+        return false;
+    }
+    return parse(file, path);
+}
+
+bool SignalPlan::parse(std::istream& in, const std::string& source) {
+    heads.clear();
+    phases.clear();
+    phaseEnds.clear();
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword)) {
+            continue; // Blank or comment
+        }
+
+        std::string name;
+        if (keyword == "head") {
+            std::string approachText;
+            Direction approach;
+            if (!(fields >> name >> approachText) || !parseDirection(approachText, approach)) {
+                std::cerr << "Error: " << source << ":" << lineNumber << ": expected 'head <name> <NORTH|SOUTH|EAST|WEST>'" << std::endl;
+                return false;
+            }
+            if (!phases.empty()) {
+                std::cerr << "Error: " << source << ":" << lineNumber << ": heads must come before the first phase" << std::endl;
+                return false;
+            }
+            addHead(name, approach);
+        } else if (keyword == "phase") {
+            float duration;
+            if (!(fields >> name >> duration) || duration < 0.0f) {
+                std::cerr << "Error: " << source << ":" << lineNumber << ": expected 'phase <name> <seconds> <colours>'" << std::endl;
+                return false;
+            }
+            std::vector<LightColor> colors;
+            std::string colorText;
+            LightColor color;
+            while (fields >> colorText) {
+                if (!parseColor(colorText, color)) {
+                    std::cerr << "Error: " << source << ":" << lineNumber << ": unknown colour '" << colorText << "', use R, Y or G" << std::endl;
+                    return false;
+                }
+                colors.push_back(color);
+            }
+            if (!addPhase(name, duration, colors)) {
+                std::cerr << "Error: " << source << ":" << lineNumber << ": phase " << name << " has " << colors.size()
+                          << " colours for " << heads.size() << " heads" << std::endl;
+                return false;
+            }
+        } else {
+            std::cerr << "Error: " << source << ":" << lineNumber << ": unknown entry '" << keyword << "'" << std::endl;
+            return false;
+        }
+    }
+
+    if (phases.empty() || getCycleLength() <= 0.0f) {
+        std::cerr << "Error: " << source << ": a plan needs at least one phase and a cycle longer than 0s" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SignalPlan::addHead(const std::string& name, Direction approach) {
+    if (!phases.empty()) {
+        return false;
+    }
+    heads.push_back({ name, approach });
+    return true;
+}
+
+bool SignalPlan::addPhase(const std::string& name, float duration, const std::vector<LightColor>& colors) {
+    if (colors.size() != heads.size()) {
+        return false;
+    }
+    SignalPhase phase;
+    phase.name = name;
+    phase.duration = duration;
+    phase.heads = colors;
+    // LightColor is ordered RED < YELLOW < GREEN, so the most permissive head wins
+    std::fill(std::begin(phase.approach), std::end(phase.approach), LightColor::RED);
+    for (size_t h = 0; h < heads.size(); ++h) {
+        LightColor& approach = phase.approach[static_cast<int>(heads[h].approach)];
+        approach = std::max(approach, colors[h]);
+    }
+    phases.push_back(std::move(phase));
+    phaseEnds.push_back((phaseEnds.empty() ? 0.0f : phaseEnds.back()) + duration);
+    return true;
+}
+
+const std::vector<SignalHead>& SignalPlan::getHeads() const {
+    return heads;
+}
+
+const std::vector<SignalPhase>& SignalPlan::getPhases() const {
+    return phases;
+}
+
+const SignalPhase& SignalPlan::getPhase(size_t index) const {
+    return phases[index];
+}
+
+size_t SignalPlan::getPhaseCount() const {
+    return phases.size();
+}
+
+float SignalPlan::getPhaseEnd(size_t index) const {
+    return phaseEnds[index];
+}
+
+float SignalPlan::getCycleLength() const {
+    return phaseEnds.empty() ? 0.0f : phaseEnds.back();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "VehicleStore.h"
+
+enum class LightColor : std::uint8_t { RED, YELLOW, GREEN };
+
+const char* toString(LightColor color);
+
+// One signal head, facing the vehicles on one approach. An approach may have several heads
+// (e.g. a through head and a turn arrow), vehicles there may go when any of them is green.
+struct SignalHead {
+    std::string name;
+    Direction approach;
+};
+
+struct SignalPhase {
+    std::string name;
+    float duration;                         // Seconds, 0 is allowed (shown only when the cycle wraps)
+    std::vector<LightColor> heads;          // One colour per head, in plan order
+    LightColor approach[DIRECTION_COUNT];   // Most permissive head colour per approach, filled by the plan
+};
+
+// A fixed sequence of phases over any number of heads, run as a repeating cycle.
+//
+// Plan files are plain text, one entry per line, '#' starts a comment:
+//     head <name> <NORTH|SOUTH|EAST|WEST>
+//     phase <name> <seconds> <R|Y|G per head, in head order>
+class SignalPlan {
+public:
+    // The original two-phase cycle: N-S green, N-S yellow, all red, E-W green, E-W yellow, all red
+    static SignalPlan makeFixedTime(float cycleDuration, float yellowDuration);
+
+    bool load(const std::string& path);
+    bool parse(std::istream& in, const std::string& source);
+
+    // Heads have to be added before any phase. addPhase takes one colour per head, in head
+    // order, and returns false if the count doesn't match.
+    bool addHead(const std::string& name, Direction approach);
+    bool addPhase(const std::string& name, float duration, const std::vector<LightColor>& colors);
+
+    const std::vector<SignalHead>& getHeads() const;
+    const std::vector<SignalPhase>& getPhases() const;
+    const SignalPhase& getPhase(size_t index) const;
+    size_t getPhaseCount() const;
+
+    // Cycle time at which phase index ends
+    float getPhaseEnd(size_t index) const;
+    float getCycleLength() const;
+
+private:
+    std::vector<SignalHead> heads;
+    std::vector<SignalPhase> phases;
+    std::vector<float> phaseEnds; // Running total of durations
+};
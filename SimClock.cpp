@@ -0,0 +1,43 @@
+#include "SimClock.h"
+
+SimClock::SimClock(float timestep, float timeScale, int maxStepsPerFrame)
+    : timestep(timestep), timeScale(timeScale), maxStepsPerFrame(maxStepsPerFrame), accumulator(0.0) {
+}
+
+int SimClock::stepsFor(float realSeconds) {
+    if (isUnbounded()) {
+        return maxStepsPerFrame;
+    }
+
+    accumulator += static_cast<double>(realSeconds) * timeScale;
+    int steps = static_cast<int>(accumulator / timestep);
+    if (steps > maxStepsPerFrame) {
+        // Drop the backlog instead of trying to catch up on it
+        steps = maxStepsPerFrame;
+        accumulator = 0.0;
+    } else {
+        accumulator -= steps * static_cast<double>(timestep);
+    }
+    return steps;
+}
+
+float SimClock::getTimestep() const {
+    return timestep;
+}
+
+float SimClock::getTimeScale() const {
+    return timeScale;
+}
+
+void SimClock::setTimeScale(float scale) {
+    timeScale = scale;
+    accumulator = 0.0;
+}
+
+bool SimClock::isUnbounded() const {
+    return timeScale <= 0.0f;
+}
+
+void SimClock::reset() {
+    accumulator = 0.0;
+}
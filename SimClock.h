@@ -0,0 +1,25 @@
+#pragma once
+
+// Fixed-timestep simulation clock. Real frame time is scaled and accumulated, and the
+// caller runs one IntersectionSim::step(getTimestep()) per step returned by stepsFor(),
+// so results do not depend on the frame rate.
+class SimClock {
+public:
+    // timeScale <= 0 means "as fast as possible" (see isUnbounded)
+    explicit SimClock(float timestep = 1.0f / 60.0f, float timeScale = 1.0f, int maxStepsPerFrame = 240);
+
+    // Number of fixed steps owed for realSeconds of wall-clock time
+    int stepsFor(float realSeconds);
+
+    float getTimestep() const;
+    float getTimeScale() const;
+    void setTimeScale(float scale);
+    bool isUnbounded() const;
+    void reset();
+
+private:
+    float timestep;
+    float timeScale;
+    int maxStepsPerFrame; // Stops a slow frame from snowballing into ever longer catch-up frames
+    double accumulator;
+};
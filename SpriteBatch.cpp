@@ -0,0 +1,72 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <numeric>
+
+// Gap between packed images
+const unsigned ATLAS_PADDING = 2;
+const unsigned ATLAS_MAX_WIDTH = 2048;
+
+bool TextureAtlas::build(AssetManager& assets, const std::vector<std::string>& paths) {
+    assets.preloadImages(paths); // Any not requested yet start decoding together
+    std::vector<AssetHandle<sf::Image>> images(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        images[i] = assets.getImage(paths[i]);
+        if (!images[i]) {
+            return false;
+        }
+    }
+
+    // Shelf packing: tallest images first, left to right, starting a new row when one is full
+    std::vector<size_t> order(images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return images[a]->getSize().y > images[b]->getSize().y;
+    });
+
+    unsigned maxWidth = std::min(ATLAS_MAX_WIDTH, sf::Texture::getMaximumSize());
+    unsigned x = 0, y = 0, rowHeight = 0, atlasWidth = 0;
+    regions.assign(images.size(), sf::IntRect());
+    for (size_t index : order) {
+        sf::Vector2u size = images[index]->getSize();
+        if (x > 0 && x + size.x > maxWidth) {
+            x = 0;
+            y += rowHeight + ATLAS_PADDING;
+            rowHeight = 0;
+        }
+        regions[index] = sf::IntRect(x, y, size.x, size.y);
+        x += size.x + ATLAS_PADDING;
+        rowHeight = std::max(rowHeight, size.y);
+        atlasWidth = std::max(atlasWidth, x);
+    }
+
+    sf::Image atlas;
+    atlas.create(std::max(atlasWidth, 1u), std::max(y + rowHeight, 1u), sf::Color::Transparent);
+    for (size_t i = 0; i < images.size(); ++i) {
+        atlas.copy(*images[i], regions[i].left, regions[i].top);
+    }
+    return texture.loadFromImage(atlas);
+}
+
+SpriteBatch::SpriteBatch(const sf::Texture& texture)
+    : texture(&texture), vertices(sf::Quads) {
+}
+
+void SpriteBatch::clear() {
+    vertices.clear();
+}
+
+void SpriteBatch::add(const sf::IntRect& region, const sf::Transform& transform) {
+    float left = static_cast<float>(region.left);
+    float top = static_cast<float>(region.top);
+    float width = static_cast<float>(region.width);
+    float height = static_cast<float>(region.height);
+
+    vertices.append(sf::Vertex(transform.transformPoint(0, 0), sf::Vector2f(left, top)));
+    vertices.append(sf::Vertex(transform.transformPoint(width, 0), sf::Vector2f(left + width, top)));
+    vertices.append(sf::Vertex(transform.transformPoint(width, height), sf::Vector2f(left + width, top + height)));
+    vertices.append(sf::Vertex(transform.transformPoint(0, height), sf::Vector2f(left, top + height)));
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target) const {
+    target.draw(vertices, sf::RenderStates(texture));
+}
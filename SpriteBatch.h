@@ -0,0 +1,40 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include "AssetManager.h"
+
+// Several images packed into one texture, so everything drawn from it can share a draw call
+class TextureAtlas {
+public:
+    // Pack the images in order, region i is paths[i]. False if any fail to load. Images the
+    // manager is already loading in the background are waited for, not loaded again.
+    bool build(AssetManager& assets, const std::vector<std::string>& paths);
+
+    const sf::Texture& getTexture() const { return texture; }
+    const sf::IntRect& getRegion(size_t index) const { return regions[index]; }
+
+private:
+    sf::Texture texture;
+    std::vector<sf::IntRect> regions;
+};
+
+// Textured quads collected over a frame and drawn with a single draw call. The vertex array
+// keeps its storage between frames, so rebuilding it every frame doesn't allocate.
+class SpriteBatch {
+public:
+    explicit SpriteBatch(const sf::Texture& texture);
+
+    void clear();
+
+    // Same placement as an sf::Sprite showing region with this transform
+    void add(const sf::IntRect& region, const sf::Transform& transform);
+
+    void draw(sf::RenderTarget& target) const;
+    size_t getSpriteCount() const { return vertices.getVertexCount() / 4; }
+
+private:
+    const sf::Texture* texture;
+    sf::VertexArray vertices;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// What push() does when the ring is full
+enum class OverflowPolicy {
+    BLOCK, // Wait for the consumer to make room (nothing is lost, the producer may stall)
+    DROP,  // Discard the new item
+    COUNT  // Discard the new item and count it (see getOverflowCount)
+};
+
+// Bounded lock-free single-producer/single-consumer ring buffer. push() may only be called
+// from one thread and popBatch() from one other thread. Capacity is rounded up to a power of two.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity, OverflowPolicy policy = OverflowPolicy::COUNT)
+        : policy(policy) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        buffer.resize(size);
+        mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side. Returns false if the item was dropped.
+    bool push(const T& item) {
+        size_t writeIndex = head.load(std::memory_order_relaxed);
+        if (writeIndex - cachedTail > mask) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            while (writeIndex - cachedTail > mask) {
+                if (policy != OverflowPolicy::BLOCK) {
+                    if (policy == OverflowPolicy::COUNT) {
+                        overflowCount.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    return false;
+                }
+                std::this_thread::yield();
+                cachedTail = tail.load(std::memory_order_acquire);
+            }
+        }
+        buffer[writeIndex & mask] = item;
+        head.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Moves up to maxItems into out and returns how many were taken.
+    size_t popBatch(T* out, size_t maxItems) {
+        size_t readIndex = tail.load(std::memory_order_relaxed);
+        if (cachedHead == readIndex) {
+            cachedHead = head.load(std::memory_order_acquire);
+        }
+        size_t available = cachedHead - readIndex;
+        size_t count = available < maxItems ? available : maxItems;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = std::move(buffer[(readIndex + i) & mask]);
+        }
+        tail.store(readIndex + count, std::memory_order_release);
+        return count;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    size_t getOverflowCount() const {
+        return overflowCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<T> buffer;
+    size_t mask;
+    OverflowPolicy policy;
+
+    // Producer and consumer indices on separate cache lines, each side keeps a cached copy
+    // of the other's index so it only touches the shared line when it has to
+    alignas(64) std::atomic<size_t> head{0}; // Next slot to write
+    size_t cachedTail = 0;
+    alignas(64) std::atomic<size_t> tail{0}; // Next slot to read
+    size_t cachedHead = 0;
+    alignas(64) std::atomic<size_t> overflowCount{0};
+};
@@ -1,17 +1,13 @@
 #include "Vehicle.h"
-#include <random>
 
-Vehicle::Vehicle(const std::string& plate, VehicleType vehicleType)
+Vehicle::Vehicle(const std::string& plate, VehicleType vehicleType, Xoshiro256& speedRandom)
     : numberPlate(plate), type(vehicleType), challanStatus(ChallanStatus::INACTIVE) {
-    setRandomSpeed();
+    setRandomSpeed(speedRandom);
 }
 
-void Vehicle::setRandomSpeed() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+void Vehicle::setRandomSpeed(Xoshiro256& speedRandom) {
     int maxSpeed = (type == VehicleType::REGULAR) ? 60 : (type == VehicleType::HEAVY) ? 40 : 80;
-    std::uniform_int_distribution<> dis(1, maxSpeed);
-    speed = dis(gen);
+    speed = 1 + static_cast<int>(speedRandom.nextBelow(maxSpeed));
 }
 
 void Vehicle::incrementSpeed() {
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include "Random.h"
 
-enum class VehicleType { REGULAR, HEAVY, EMERGENCY };
-enum class ChallanStatus { INACTIVE, ACTIVE };
+enum class VehicleType : std::uint8_t { REGULAR, HEAVY, EMERGENCY };
+enum class ChallanStatus : std::uint8_t { INACTIVE, ACTIVE, PAID };
 
 class Vehicle {
 private:
@@ -13,9 +15,10 @@ private:
     ChallanStatus challanStatus;
 
 public:
-    Vehicle(const std::string& plate, VehicleType vehicleType);
+    // Speeds are drawn from the caller's stream, normally RandomStream::SPEED of a seeded RandomStreams
+    Vehicle(const std::string& plate, VehicleType vehicleType, Xoshiro256& speedRandom);
 
-    void setRandomSpeed();
+    void setRandomSpeed(Xoshiro256& speedRandom);
     void incrementSpeed();
     int getSpeed() const;
     std::string getNumberPlate() const;
@@ -0,0 +1,92 @@
+#include "VehicleKernels.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Unit vectors indexed by Direction (NORTH, SOUTH, EAST, WEST), padded to 8 for the AVX2 lookup
+alignas(32) static const float UNIT_X[8] = { 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+alignas(32) static const float UNIT_Y[8] = { 1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+static void integrateScalar(float* posX, float* posY, const float* speed, const std::uint8_t* direction,
+                            const std::uint8_t* moveMask, size_t begin, size_t end, float dt) {
+    for (size_t i = begin; i < end; ++i) {
+        float step = speed[i] * dt * (moveMask[i] ? 1.0f : 0.0f);
+        posX[i] += UNIT_X[direction[i]] * step;
+        posY[i] += UNIT_Y[direction[i]] * step;
+    }
+}
+
+void integrateVehicles(float* posX, float* posY, const float* speed, const Direction* direction,
+                       const std::uint8_t* moveMask, size_t count, float dt) {
+    static_assert(sizeof(Direction) == 1, "Direction must stay one byte for the vector loads");
+    const std::uint8_t* directionBytes = reinterpret_cast<const std::uint8_t*>(direction);
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256 unitX = _mm256_load_ps(UNIT_X);
+    const __m256 unitY = _mm256_load_ps(UNIT_Y);
+    const __m256 dtVec = _mm256_set1_ps(dt);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    for (; i + 8 <= count; i += 8) {
+        // Widen 8 direction/mask bytes to 32-bit lanes
+        __m256i dir = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(directionBytes + i)));
+        __m256i mask = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(moveMask + i)));
+        __m256 moving = _mm256_andnot_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(mask, zero)), one);
+
+        // Per-direction unit vector lookup straight from the tables in registers
+        __m256 dx = _mm256_permutevar8x32_ps(unitX, dir);
+        __m256 dy = _mm256_permutevar8x32_ps(unitY, dir);
+
+        __m256 step = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(speed + i), dtVec), moving);
+        _mm256_storeu_ps(posX + i, _mm256_add_ps(_mm256_loadu_ps(posX + i), _mm256_mul_ps(dx, step)));
+        _mm256_storeu_ps(posY + i, _mm256_add_ps(_mm256_loadu_ps(posY + i), _mm256_mul_ps(dy, step)));
+    }
+#elif defined(__SSE2__)
+    const __m128 dtVec = _mm_set1_ps(dt);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i north = _mm_set1_epi32(static_cast<int>(Direction::NORTH));
+    const __m128i south = _mm_set1_epi32(static_cast<int>(Direction::SOUTH));
+    const __m128i east = _mm_set1_epi32(static_cast<int>(Direction::EAST));
+    const __m128i west = _mm_set1_epi32(static_cast<int>(Direction::WEST));
+
+    for (; i + 4 <= count; i += 4) {
+        // Widen 4 direction/mask bytes to 32-bit lanes
+        int dirBits, maskBits;
+        std::memcpy(&dirBits, directionBytes + i, 4);
+        std::memcpy(&maskBits, moveMask + i, 4);
+        __m128i dir = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(dirBits), zero), zero);
+        __m128i mask = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(maskBits), zero), zero);
+        __m128 moving = _mm_andnot_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(mask, zero)), one);
+
+        // SSE2 has no variable permute, so build the unit vectors with compares
+        __m128 dx = _mm_sub_ps(_mm_and_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(dir, west)), one),
+                               _mm_and_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(dir, east)), one));
+        __m128 dy = _mm_sub_ps(_mm_and_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(dir, north)), one),
+                               _mm_and_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(dir, south)), one));
+
+        __m128 step = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(speed + i), dtVec), moving);
+        _mm_storeu_ps(posX + i, _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(dx, step)));
+        _mm_storeu_ps(posY + i, _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(dy, step)));
+    }
+#endif
+
+    // Remainder (or everything when no SIMD path is available)
+    integrateScalar(posX, posY, speed, directionBytes, moveMask, i, count, dt);
+}
+
+const char* integrationKernelName() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "VehicleStore.h"
+
+// Advance every vehicle whose moveMask entry is non-zero by speed * dt along the unit
+// vector of its direction. Uses AVX2 or SSE2 when the compiler targets them (build with
+// -march=native to get AVX2) and a scalar loop otherwise; all paths give identical results.
+void integrateVehicles(float* posX, float* posY, const float* speed, const Direction* direction,
+                       const std::uint8_t* moveMask, size_t count, float dt);
+
+// "AVX2", "SSE2" or "scalar"
+const char* integrationKernelName();
@@ -0,0 +1,73 @@
+#include "VehicleStore.h"
+
+void VehicleStore::reserve(size_t count) {
+    posX.reserve(count);
+    posY.reserve(count);
+    speed.reserve(count);
+    mockSpeed.reserve(count);
+    direction.reserve(count);
+    type.reserve(count);
+    lane.reserve(count);
+    flags.reserve(count);
+    plate.reserve(count);
+}
+
+SimVehicle VehicleStore::get(size_t i) const {
+    return { plate[i], { posX[i], posY[i] }, direction[i], type[i], lane[i], speed[i], mockSpeed[i] };
+}
+
+size_t VehicleStore::push(const SimVehicle& vehicle) {
+    posX.push_back(vehicle.position.x);
+    posY.push_back(vehicle.position.y);
+    speed.push_back(vehicle.speed);
+    mockSpeed.push_back(vehicle.mockSpeed);
+    direction.push_back(vehicle.direction);
+    type.push_back(vehicle.type);
+    lane.push_back(vehicle.lane);
+    flags.push_back(0);
+    plate.push_back(vehicle.plateNumber);
+    return size() - 1;
+}
+
+void VehicleStore::swapRemove(size_t i) {
+    size_t last = size() - 1;
+    if (i != last) {
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        speed[i] = speed[last];
+        mockSpeed[i] = mockSpeed[last];
+        direction[i] = direction[last];
+        type[i] = type[last];
+        lane[i] = lane[last];
+        flags[i] = flags[last];
+        plate[i] = plate[last];
+    }
+    posX.pop_back();
+    posY.pop_back();
+    speed.pop_back();
+    mockSpeed.pop_back();
+    direction.pop_back();
+    type.pop_back();
+    lane.pop_back();
+    flags.pop_back();
+    plate.pop_back();
+}
+
+const char* toString(Direction direction) {
+    switch (direction) {
+        case Direction::NORTH: return "NORTH";
+        case Direction::SOUTH: return "SOUTH";
+        case Direction::EAST: return "EAST";
+        case Direction::WEST: return "WEST";
+    }
+    return "";
+}
+
+const char* typeCode(VehicleType type) {
+    switch (type) {
+        case VehicleType::REGULAR: return "R";
+        case VehicleType::HEAVY: return "H";
+        case VehicleType::EMERGENCY: return "E";
+    }
+    return "";
+}
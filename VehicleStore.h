@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Identifiers.h"
+#include "Vehicle.h"
+
+// Direction of travel. NORTH means coming from the north (moving down the screen), and a
+// vehicle keeps the direction it exits towards once it has turned.
+enum class Direction : std::uint8_t { NORTH, SOUTH, EAST, WEST };
+
+const int DIRECTION_COUNT = 4;
+const int VEHICLE_TYPE_COUNT = 3;
+
+// Bits in VehicleStore::flags
+const std::uint8_t FLAG_TURNED = 1 << 0; // Has crossed the signal and picked its exit
+
+// Plain 2D point so the engine does not depend on SFML (the viewer converts it to sf::Vector2f)
+struct Vec2 {
+    float x;
+    float y;
+};
+
+// A single vehicle outside the store, used for vehicles waiting in the spawn queues
+struct SimVehicle {
+    PlateNumber plateNumber;
+    Vec2 position;
+    Direction direction;
+    VehicleType type;
+    std::uint8_t lane;     // 1 or 2
+    float speed;           // actual movement speed in pixels per second
+    int mockSpeed;         // for challan status
+};
+
+// Structure-of-arrays storage for the vehicles on the road. Index i in every array is the
+// same vehicle; the update loop walks the arrays it needs linearly. Render state is kept
+// by the viewer, not here.
+struct VehicleStore {
+    std::vector<float> posX, posY;
+    std::vector<float> speed;
+    std::vector<int> mockSpeed;
+    std::vector<Direction> direction;
+    std::vector<VehicleType> type;
+    std::vector<std::uint8_t> lane;
+    std::vector<std::uint8_t> flags;
+    std::vector<PlateNumber> plate; // Cold, only read when reporting a violation
+
+    size_t size() const { return posX.size(); }
+    bool hasTurned(size_t i) const { return (flags[i] & FLAG_TURNED) != 0; }
+
+    void reserve(size_t count);
+    size_t push(const SimVehicle& vehicle);
+    SimVehicle get(size_t i) const;
+    // Remove vehicle i by moving the last vehicle into its slot
+    void swapRemove(size_t i);
+};
+
+const char* toString(Direction direction);
+const char* typeCode(VehicleType type); // "R", "H" or "E"
@@ -0,0 +1,195 @@
+// Microbenchmarks for the simulation hot paths, built on Google Benchmark.
+// Run with --benchmark_format=json (or --benchmark_out=results.json) for machine-readable output.
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "ChallanStore.h"
+#include "IdAllocator.h"
+#include "IntersectionSim.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include "Random.h"
+#include "VehicleKernels.h"
+#include "challanProcess.h"
+
+const float BENCH_TIMESTEP = 1.0f / 60.0f;
+const unsigned int BENCH_SEED = 42;
+
+// A sim with count vehicles already on the road, long enough that it never finishes
+std::unique_ptr<IntersectionSim> makePopulatedSim(size_t count, StageProfiler* profiler) {
+    SimConfig config;
+    config.seed = BENCH_SEED;
+    config.duration = 1e9f;
+    auto sim = std::make_unique<IntersectionSim>(config);
+    sim->populate(count);
+    sim->setProfiler(profiler);
+    return sim;
+}
+
+// Vehicles drive off over time, rebuild outside the timed region once half have gone
+void refillIfDrained(benchmark::State& state, std::unique_ptr<IntersectionSim>& sim, size_t count,
+                     StageProfiler* profiler) {
+    if (sim->getVehicles().size() * 2 < count) {
+        state.PauseTiming();
+        sim = makePopulatedSim(count, profiler);
+        state.ResumeTiming();
+    }
+}
+
+// Whole step: spawn, admit, signals, violations, move and despawn
+static void BM_SimStep(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    auto sim = makePopulatedSim(count, nullptr);
+    for (auto _ : state) {
+        sim->step(BENCH_TIMESTEP);
+        refillIfDrained(state, sim, count, nullptr);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK(BM_SimStep)->RangeMultiplier(10)->Range(100, 100000);
+
+// Move stage only: lane ordering, leader lookup, gap checks and integration. Timed by the
+// sim's own stage timer so the rest of step() stays out of the numbers.
+static void BM_MoveVehicles(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    StageProfiler profiler;
+    auto sim = makePopulatedSim(count, &profiler);
+    for (auto _ : state) {
+        sim->step(BENCH_TIMESTEP);
+        state.SetIterationTime(profiler.getLastDuration(Stage::MOVE).count() * 1e-9);
+        refillIfDrained(state, sim, count, &profiler);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK(BM_MoveVehicles)->RangeMultiplier(10)->Range(100, 100000)->UseManualTime();
+
+// Speed updates and violation detection
+static void BM_DetectViolations(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    StageProfiler profiler;
+    auto sim = makePopulatedSim(count, &profiler);
+    for (auto _ : state) {
+        sim->step(BENCH_TIMESTEP);
+        state.SetIterationTime(profiler.getLastDuration(Stage::VIOLATIONS).count() * 1e-9);
+        refillIfDrained(state, sim, count, &profiler);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+}
+BENCHMARK(BM_DetectViolations)->RangeMultiplier(10)->Range(100, 100000)->UseManualTime();
+
+// Position integration kernel on its own, every vehicle moving
+static void BM_IntegrateVehicles(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    Xoshiro256 random(BENCH_SEED);
+    std::vector<float> posX(count), posY(count), speed(count);
+    std::vector<Direction> direction(count);
+    std::vector<std::uint8_t> moveMask(count, 1);
+    for (size_t i = 0; i < count; ++i) {
+        posX[i] = static_cast<float>(random.nextDouble() * 1000.0);
+        posY[i] = static_cast<float>(random.nextDouble() * 1000.0);
+        speed[i] = 30.0f + static_cast<float>(random.nextBelow(20));
+        direction[i] = static_cast<Direction>(random.nextBelow(DIRECTION_COUNT));
+    }
+    for (auto _ : state) {
+        integrateVehicles(posX.data(), posY.data(), speed.data(), direction.data(), moveMask.data(),
+                          count, BENCH_TIMESTEP);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(count));
+    state.SetLabel(integrationKernelName());
+}
+BENCHMARK(BM_IntegrateVehicles)->RangeMultiplier(10)->Range(100, 100000);
+
+// Violations pushed through the pipeline and issued by a worker pool of range(0) workers.
+// The pool is started once, and the global store and challan IDs are reset between
+// iterations, so only issuing is timed.
+static void BM_ChallanThroughput(benchmark::State& state) {
+    const size_t VIOLATIONS_PER_RUN = 10000;
+    int workerCount = static_cast<int>(state.range(0));
+    SpeedViolation violation = { 0, VehicleType::REGULAR, 95.0f, Direction::NORTH, ChallanStatus::ACTIVE };
+    ViolationPipeline pipeline(4096, OverflowPolicy::BLOCK);
+    ChallanWorkerPool pool(pipeline, workerCount);
+    size_t issuedTarget = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        challanStore.load({});
+        resumeChallanIDs(0);
+        state.ResumeTiming();
+        for (size_t i = 0; i < VIOLATIONS_PER_RUN; ++i) {
+            violation.vehicleID = static_cast<PlateNumber>(i);
+            pipeline.submit(violation);
+        }
+        // Workers count a challan after it is in the store, so the next reset can't race them
+        issuedTarget += VIOLATIONS_PER_RUN;
+        while (pool.getIssuedCount() < issuedTarget) {
+            std::this_thread::yield();
+        }
+    }
+    pool.shutdown();
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(VIOLATIONS_PER_RUN));
+}
+BENCHMARK(BM_ChallanThroughput)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+// Plate lookups against a store of range(0) challans
+static void BM_ChallanLookupByPlate(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    IdAllocator plates(PLATE_COUNT, BENCH_SEED);
+    std::vector<Challan> challans(count);
+    std::vector<PlateNumber> issuedPlates(count);
+    for (size_t i = 0; i < count; ++i) {
+        issuedPlates[i] = plates.next();
+        challans[i] = { static_cast<ChallanNumber>(i), issuedPlates[i], 0, 0, 5850.0f, ChallanStatus::ACTIVE };
+    }
+    ChallanStore store;
+    store.load(std::move(challans));
+
+    Xoshiro256 random(BENCH_SEED);
+    for (auto _ : state) {
+        PlateNumber plate = issuedPlates[random.nextBelow(count)];
+        benchmark::DoNotOptimize(store.findByVehicleID(plate));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChallanLookupByPlate)->RangeMultiplier(100)->Range(100, 1000000);
+
+// Challan ID allocation, contended across threads in the threaded runs
+static void BM_ChallanIdAllocator(benchmark::State& state) {
+    static IdAllocator ids(CHALLAN_NUMBER_COUNT, 0x43484C4E49445331ull);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ids.next());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChallanIdAllocator)->ThreadRange(1, 8);
+
+static void BM_PlateFormat(benchmark::State& state) {
+    IdAllocator plates(PLATE_COUNT, BENCH_SEED);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(formatPlate(plates.next()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PlateFormat);
+
+static void BM_RandomDraw(benchmark::State& state) {
+    Xoshiro256 random(BENCH_SEED);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(random.nextBelow(100));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RandomDraw);
+
+int main(int argc, char** argv) {
+    // Challan workers would otherwise format a log line per challan
+    setLogLevel(LogLevel::OFF);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
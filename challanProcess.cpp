@@ -0,0 +1,264 @@
+#include "challanProcess.h"
+#include "Logger.h"
+#include <algorithm>
+#include <thread>
+
+ChallanStore challanStore;
+
+const size_t VIOLATION_BATCH_SIZE = 64;
+const size_t WORKER_RUN_SIZE = 32;    // Most violations a worker takes from its own deque at once
+
+ViolationPipeline::ViolationPipeline(size_t capacity, OverflowPolicy policy)
+    : ring(capacity, policy) {
+}
+
+bool ViolationPipeline::submit(const SpeedViolation& violation) {
+    bool accepted = ring.push(violation);
+    if (accepted) {
+        // Pairs with the fence in takeBatch: either the consumer sees the new item before it
+        // sleeps or this sees it waiting. Acquire/release alone lets both miss each other.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // Only pay for a notify when the consumer has actually gone to sleep. Taking the mutex
+        // first waits out a consumer between its last check and blocking.
+        if (consumerWaiting.load(std::memory_order_relaxed)) {
+            { std::lock_guard<std::mutex> lock(waitMutex); }
+            violationNotifier.notify_one();
+        }
+    }
+    return accepted;
+}
+
+bool ViolationPipeline::takeBatch(std::vector<SpeedViolation>& out, size_t maxBatch, std::chrono::milliseconds maxWait) {
+    out.resize(maxBatch);
+    size_t count = ring.popBatch(out.data(), maxBatch);
+    if (count == 0) {
+        if (stopped.load(std::memory_order_acquire)) {
+            out.clear();
+            return false;
+        }
+
+        // Wait for a notification or stop signal. The flag is published before the ring is
+        // checked again (see submit), so a push can't slip past unseen.
+        std::unique_lock<std::mutex> lock(waitMutex);
+        consumerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        violationNotifier.wait_for(lock, maxWait, [this] { return !ring.empty() || stopped.load(); });
+        consumerWaiting.store(false, std::memory_order_relaxed);
+        lock.unlock();
+
+        count = ring.popBatch(out.data(), maxBatch);
+    }
+    out.resize(count);
+    return true;
+}
+
+void ViolationPipeline::stop() {
+    {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        stopped.store(true);
+    }
+    violationNotifier.notify_all();
+}
+
+size_t ViolationPipeline::getOverflowCount() const {
+    return ring.getOverflowCount();
+}
+
+// Function to format the time as a string
+std::string formatTime(std::int64_t epochSeconds) {
+    std::time_t time = static_cast<std::time_t>(epochSeconds);
+    char buffer[100];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&time));
+    return std::string(buffer);
+}
+
+// Function to get the current time in epoch seconds
+std::int64_t getCurrentTime() {
+    auto now = std::chrono::system_clock::now();
+    return std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+}
+
+// Function to calculate the due date (3 days after issue)
+std::int64_t getDueTime(std::int64_t issueTime, int daysToAdd) {
+    return issueTime + static_cast<std::int64_t>(daysToAdd) * 24 * 60 * 60;
+}
+
+// Fixed key so a restarted run continues the same sequence (see resumeChallanIDs)
+const std::uint64_t CHALLAN_ID_KEY = 0x43484C4E49445331ull;
+IdAllocator challanIds(CHALLAN_NUMBER_COUNT, CHALLAN_ID_KEY);
+
+// Function to generate a unique challan ID, lock-free so workers can call it concurrently
+ChallanNumber generateChallanID() {
+    return challanIds.next();
+}
+
+void resumeChallanIDs(std::uint64_t issuedCount) {
+    challanIds.resume(issuedCount);
+}
+
+std::uint64_t countChallanIDsUsed(const std::vector<Challan>& recovered) {
+    std::uint64_t used = 0;
+    for (const Challan& challan : recovered) {
+        used = std::max(used, challanIds.indexOf(challan.challanID) + 1);
+    }
+    return used;
+}
+
+// Fine plus 17% tax, emergency vehicles aren't fined
+float getChallanAmount(VehicleType type) {
+    float amount = 0;
+    if (type == VehicleType::REGULAR)
+    {
+        amount = 5000 + 0.17*5000;
+    }
+    else if (type == VehicleType::HEAVY)
+    {
+        amount = 7000 + 0.17*7000;
+    }
+    return amount;
+}
+
+void issueChallans(const std::vector<SpeedViolation>& violations) {
+    std::int64_t issueTime = getCurrentTime();
+    std::vector<Challan> challans;
+    challans.reserve(violations.size());
+    for (const SpeedViolation& violation : violations) {
+        challans.push_back({
+            generateChallanID(),
+            violation.vehicleID,
+            issueTime,
+            getDueTime(issueTime),
+            getChallanAmount(violation.type),
+            violation.status
+        });
+    }
+    challanStore.addBatch(challans.data(), challans.size());
+
+    for (size_t i = 0; i < challans.size(); ++i) {
+        logChallanIssued(challans[i]);
+
+        // The logger prints it on its own thread, the worker only copies the text
+        if (isLogEnabled(LogLevel::INFO)) {
+            const SpeedViolation& violation = violations[i];
+            logMessage(LogLevel::INFO, "Processing challan for Vehicle: " + formatPlate(violation.vehicleID) +
+                                       " | Speed: " + std::to_string(violation.speed) +
+                                       " | Direction: " + toString(violation.direction));
+        }
+    }
+}
+
+ChallanWorkerPool::ChallanWorkerPool(ViolationPipeline& pipeline, int workerCount, std::chrono::milliseconds processingLatency)
+    : pipeline(pipeline), processingLatency(processingLatency) {
+    if (workerCount < 1) {
+        workerCount = 1;
+    }
+    for (int i = 0; i < workerCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ChallanWorkerPool::workerLoop, this, static_cast<size_t>(i));
+    }
+    dispatcher = std::thread(&ChallanWorkerPool::dispatchLoop, this);
+}
+
+ChallanWorkerPool::~ChallanWorkerPool() {
+    shutdown();
+}
+
+void ChallanWorkerPool::shutdown() {
+    if (joined) {
+        return;
+    }
+    pipeline.stop();
+    dispatcher.join(); // Returns once the ring is drained
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        dispatchDone.store(true);
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    joined = true;
+}
+
+size_t ChallanWorkerPool::getIssuedCount() const {
+    return issued.load();
+}
+
+int ChallanWorkerPool::getWorkerCount() const {
+    return static_cast<int>(workers.size());
+}
+
+void ChallanWorkerPool::dispatchLoop() {
+    std::vector<SpeedViolation> batch;
+    batch.reserve(VIOLATION_BATCH_SIZE);
+    size_t next = 0;
+
+    while (pipeline.takeBatch(batch, VIOLATION_BATCH_SIZE, std::chrono::milliseconds(100))) {
+        if (batch.empty()) {
+            continue;
+        }
+        // Counted before it is published so a worker's decrement can't run ahead of it. Holding
+        // idleMutex until the items are in keeps a worker from waking to an empty deque.
+        std::lock_guard<std::mutex> idleLock(idleMutex);
+        pending.fetch_add(batch.size());
+        size_t chunk = (batch.size() + queues.size() - 1) / queues.size();
+        for (size_t begin = 0; begin < batch.size(); begin += chunk) {
+            size_t end = std::min(begin + chunk, batch.size());
+            WorkerQueue& queue = *queues[next];
+            next = (next + 1) % queues.size();
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.items.insert(queue.items.end(), batch.begin() + begin, batch.begin() + end);
+        }
+        workAvailable.notify_all();
+    }
+}
+
+// A run from the front of the own deque, otherwise half of another deque from the back.
+// With a processing latency every violation is taken alone so idle workers can still steal
+// the rest.
+bool ChallanWorkerPool::takeWork(size_t id, std::vector<SpeedViolation>& out) {
+    size_t runSize = processingLatency.count() > 0 ? 1 : WORKER_RUN_SIZE;
+    out.clear();
+    for (size_t k = 0; k < queues.size(); ++k) {
+        WorkerQueue& queue = *queues[(id + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.items.empty()) {
+            continue;
+        }
+        if (k == 0) {
+            size_t count = std::min(runSize, queue.items.size());
+            out.assign(queue.items.begin(), queue.items.begin() + count);
+            queue.items.erase(queue.items.begin(), queue.items.begin() + count);
+        } else {
+            size_t count = std::min(runSize, (queue.items.size() + 1) / 2);
+            out.assign(queue.items.end() - count, queue.items.end());
+            queue.items.erase(queue.items.end() - count, queue.items.end());
+        }
+        pending.fetch_sub(out.size());
+        return true;
+    }
+    return false;
+}
+
+void ChallanWorkerPool::workerLoop(size_t id) {
+    std::vector<SpeedViolation> run;
+    run.reserve(WORKER_RUN_SIZE);
+    while (true) {
+        if (takeWork(id, run)) {
+            issueChallans(run);
+            issued.fetch_add(run.size());
+            if (processingLatency.count() > 0) {
+                std::this_thread::sleep_for(processingLatency); // Simulate processing delay
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex);
+        workAvailable.wait(lock, [this] { return pending.load() > 0 || dispatchDone.load(); });
+        if (pending.load() == 0 && dispatchDone.load()) {
+            break; // Everything has been issued
+        }
+    }
+}
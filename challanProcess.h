@@ -1,2 +1,108 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ChallanStore.h"
+#include "IntersectionSim.h"
+#include "SpscRing.h"
+
+// Issued challans, read by the menu screens in main.cpp
+extern ChallanStore challanStore;
+
+// Hands violations from the simulation thread (the only producer) to the challan dispatcher
+// (the only consumer) through a lock-free ring. The consumer drains in batches and only sleeps
+// on the condition variable when the ring is empty; the producer only takes a lock to wake it.
+class ViolationPipeline {
+public:
+    explicit ViolationPipeline(size_t capacity = 4096, OverflowPolicy policy = OverflowPolicy::COUNT);
+
+    // Producer side. Returns false if the violation was dropped because the ring was full.
+    bool submit(const SpeedViolation& violation);
+
+    // Consumer side. Waits up to maxWait for violations, then moves up to maxBatch into out.
+    // Returns false once stop() has been called and the ring is drained.
+    bool takeBatch(std::vector<SpeedViolation>& out, size_t maxBatch, std::chrono::milliseconds maxWait);
+
+    void stop();
+    size_t getOverflowCount() const;
+
+private:
+    SpscRing<SpeedViolation> ring;
+    std::mutex waitMutex;                   // Only used to sleep the consumer
+    std::condition_variable violationNotifier;
+    std::atomic<bool> consumerWaiting{false};
+    std::atomic<bool> stopped{false};
+};
+
+// Challans keep times as epoch seconds, formatTime turns one into text for display
+std::string formatTime(std::int64_t epochSeconds);
+std::int64_t getCurrentTime();
+std::int64_t getDueTime(std::int64_t issueTime, int daysToAdd = 3);
+ChallanNumber generateChallanID();
+
+// Continue the challan ID sequence after issuedCount allocations
+void resumeChallanIDs(std::uint64_t issuedCount);
+
+// Allocations the recovered challans account for: one past the furthest sequence position
+// among their IDs. Workers commit out of allocation order and a crash can lose a group
+// commit, so this can be more than the number of records.
+std::uint64_t countChallanIDsUsed(const std::vector<Challan>& recovered);
+
+// Payable amount of a challan for this vehicle type
+float getChallanAmount(VehicleType type);
+
+// Turn violations into challans and record them, taking the store lock once for all of them
+void issueChallans(const std::vector<SpeedViolation>& violations);
+
+// Pool of challan workers fed from a ViolationPipeline. A dispatcher thread is the ring's
+// single consumer and deals each batch out as one contiguous chunk per worker deque. Workers
+// take a run from the front of their own deque, and one that runs dry steals half of another
+// worker's deque from the back, so queue locks, counters and the store lock are paid per run
+// instead of per violation.
+class ChallanWorkerPool {
+public:
+    // processingLatency is an optional per-challan delay to model a slow issuing backend
+    ChallanWorkerPool(ViolationPipeline& pipeline, int workerCount,
+                      std::chrono::milliseconds processingLatency = std::chrono::milliseconds(0));
+    ~ChallanWorkerPool();
+
+    ChallanWorkerPool(const ChallanWorkerPool&) = delete;
+    ChallanWorkerPool& operator=(const ChallanWorkerPool&) = delete;
+
+    // Stop the pipeline, issue everything already queued and join all threads
+    void shutdown();
+
+    size_t getIssuedCount() const;
+    int getWorkerCount() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<SpeedViolation> items;
+    };
+
+    void dispatchLoop();
+    void workerLoop(size_t id);
+    bool takeWork(size_t id, std::vector<SpeedViolation>& out);
+
+    ViolationPipeline& pipeline;
+    std::chrono::milliseconds processingLatency;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::thread dispatcher;
+
+    std::mutex idleMutex;                 // Only used to sleep idle workers
+    std::condition_variable workAvailable;
+    std::atomic<size_t> pending{0};       // Violations sitting in worker deques
+    std::atomic<bool> dispatchDone{false};
+    std::atomic<size_t> issued{0};
+    bool joined = false;
+};
@@ -9,279 +9,139 @@
 #include <mutex>
 #include <condition_variable>
 #include <string>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include "IntersectionSim.h"
+#include "challanProcess.h"
+#include "ChallanLedger.h"
+#include "SimClock.h"
+#include "VehicleKernels.h"
+#include "AssetManager.h"
+#include "BatchRunner.h"
+#include "SpriteBatch.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include "RoadNetwork.h"
 
 enum class AppState { MENU, SIMULATION, CHALLAN_VIEW, USER_PORTAL, PAY_CHALLAN, EXIT };
 
-const sf::Vector2f NORTH_SPAWN_REGULAR_LANE1(522, 0);    // Starting from top-center
-const sf::Vector2f SOUTH_SPAWN_REGULAR_LANE1(403, 1000); // Starting from bottom-center
-const sf::Vector2f EAST_SPAWN_REGULAR_LANE1(1000, 533);  // Starting from right-center
-const sf::Vector2f WEST_SPAWN_REGULAR_LANE1(0, 410);     // Starting from left-center
+// Wall-clock time per frame the viewer may spend stepping in "as fast as possible" mode
+const std::chrono::milliseconds FAST_FRAME_BUDGET(15);
 
-const sf::Vector2f NORTH_TURN_LANE1(405, 278); // Starting from top-center
-const sf::Vector2f SOUTH_TURN_LANE1(523, 715); // Done
-const sf::Vector2f EAST_TURN_LANE1(700, 467);  // DONE
-const sf::Vector2f WEST_TURN_LANE1(290, 535);  // Starting from left-center
+// How often the profiler overlay recomputes its percentiles
+const float PROFILER_REFRESH_SECONDS = 0.5f;
 
+const std::string BACKGROUND_IMAGE = "img/Intersection6.png";
+const std::string FONT_PATH = "fonts/fonty_font.ttf";
 
-const sf::Vector2f NORTH_SPAWN_HEAVY_LANE2(580, 0);     // Starting from top-center
-const sf::Vector2f SOUTH_SPAWN_HEAVY_LANE2(450, 1000);  // Starting from bottom-center
-const sf::Vector2f EAST_SPAWN_HEAVY_LANE2(1000, 590);   // Starting from right-center
-const sf::Vector2f WEST_SPAWN_HEAVY_LANE2(0, 460);      // Starting from left-center
-
-
-const sf::Vector2f NORTH_TURN_LANE2(450, 278);    // Starting from top-center
-const sf::Vector2f SOUTH_TURN_LANE2(575, 715);    // Done
-const sf::Vector2f EAST_TURN_LANE2(700, 410);     // DONE
-const sf::Vector2f WEST_TURN_LANE2(290, 590);     // Starting from left-center
-
-const int REGULAR_VEHICLE_SPEED_LIMIT = 60;
-const int HEAVY_VEHICLE_SPEED_LIMIT = 40;
-const int EMERGENCY_VEHICLE_SPEED_LIMIT = 80;
-
+// Images packed into the sprite atlas, in this order. The lights follow LightColor order.
+enum AtlasImage { REGULAR_CAR, HEAVY_CAR, EMERGENCY_CAR, RED_LIGHT, YELLOW_LIGHT, GREEN_LIGHT };
+const std::vector<std::string> ATLAS_IMAGES = {
+    "img/RegularCar2.png", "img/Truck.png", "img/EmergencyCar.png",
+    "img/redlight.png", "img/yellowLight.png", "img/greenLight.png"
+};
 
+// Vehicle sprite scale, indexed by VehicleType
+const float VEHICLE_SCALE[VEHICLE_TYPE_COUNT] = { 0.55f, 0.70f, 0.55f };
 
+// Render side of a signal head. State and timing are owned by the engine's SignalController.
 struct TrafficLight {
-    sf::Sprite lightSprite; // Sprite for the light
-    sf::Texture redTex, yellowTex, greenTex;
-    std::string state;      // Current state: "RED", "GREEN", "YELLOW"
-    sf::Clock stateClock;   // Timer for state transitions
-    float redDuration, yellowDuration, greenDuration; // Durations for each state
-
-    TrafficLight(sf::Texture& redTex, sf::Texture& yellowTex, sf::Texture& greenTex, float redDur, float yellowDur, float greenDur) 
-        : redDuration(redDur), yellowDuration(yellowDur), greenDuration(greenDur), state("RED") {
-        this->greenTex = greenTex;
-        this->redTex = redTex;
-        this->yellowTex = yellowTex;
-        
-        lightSprite.setTexture(redTex);
+    sf::Transformable placement; // Position, rotation and scale of the light
+    sf::IntRect regions[3];      // Atlas region for each state, indexed by LightColor
+    sf::IntRect region;          // Region for the current state
+    LightColor state = LightColor::RED;
+
+    explicit TrafficLight(const TextureAtlas& atlas) {
+        for (int color = 0; color < 3; ++color) {
+            regions[color] = atlas.getRegion(RED_LIGHT + color);
+        }
+        region = regions[static_cast<int>(state)];
     }
 
-    bool canPass() const {
-        return state == "GREEN";
+    // Mirror the engine's signal state
+    void setState(LightColor newState) {
+        state = newState;
+        region = regions[static_cast<int>(state)];
     }
 };
 
-struct VehicleSprite {
-    std::string plateNumber;
-    sf::Sprite sprite;
-    std::string direction;
-    std::string type; // "R", "E", "H"
-    float speed; // actual sprite speed
-    int mockSpeed; // for challan status
-    bool hasTurned;
-};
-
-void updateTrafficLights(TrafficLight& northLight, TrafficLight& southLight, TrafficLight& eastLight, TrafficLight& westLight, sf::Clock& trafficCycleClock, float cycleDuration, float yellowDuration) {
-    float elapsed = trafficCycleClock.getElapsedTime().asSeconds();
+// Vehicle counts for one approach. The text is only laid out again when a count changes.
+struct HudPanel {
+    sf::Text text;
+    std::string title;
+    int regular = -1, emergency = -1, heavy = -1; // -1 until the first update
 
-    if (elapsed >= cycleDuration) {
-        trafficCycleClock.restart(); // Restart the cycle timer
+    HudPanel(const sf::Font& font, const std::string& title, float x, float y) : title(title) {
+        text.setFont(font);
+        text.setCharacterSize(18);
+        text.setFillColor(sf::Color::White);
+        text.setPosition(x, y);
     }
 
-    // Define the time points for the light changes
-    float greenPhaseDuration = (cycleDuration / 2) - yellowDuration;
-
-    if (elapsed < greenPhaseDuration) {
-        // North-South GREEN, East-West RED
-        if (northLight.state != "GREEN") {
-            northLight.state = "GREEN";
-            northLight.lightSprite.setTexture(northLight.greenTex);
-        }
-        if (southLight.state != "GREEN") {
-            southLight.state = "GREEN";
-            southLight.lightSprite.setTexture(southLight.greenTex);
-        }
-        if (eastLight.state != "RED") {
-            eastLight.state = "RED";
-            eastLight.lightSprite.setTexture(eastLight.redTex);
-        }
-        if (westLight.state != "RED") {
-            westLight.state = "RED";
-            westLight.lightSprite.setTexture(westLight.redTex);
-        }
-    } else if (elapsed < greenPhaseDuration + yellowDuration) {
-        // North-South YELLOW, East-West remains RED
-        if (northLight.state != "YELLOW") {
-            northLight.state = "YELLOW";
-            northLight.lightSprite.setTexture(northLight.yellowTex);
-        }
-        if (southLight.state != "YELLOW") {
-            southLight.state = "YELLOW";
-            southLight.lightSprite.setTexture(southLight.yellowTex);
-        }
-    } else if (elapsed < cycleDuration / 2) {
-        // North-South RED, East-West remains RED
-        if (northLight.state != "RED") {
-            northLight.state = "RED";
-            northLight.lightSprite.setTexture(northLight.redTex);
-        }
-        if (southLight.state != "RED") {
-            southLight.state = "RED";
-            southLight.lightSprite.setTexture(southLight.redTex);
-        }
-    } else if (elapsed < (cycleDuration / 2) + greenPhaseDuration) {
-        // East-West GREEN, North-South RED
-        if (eastLight.state != "GREEN") {
-            eastLight.state = "GREEN";
-            eastLight.lightSprite.setTexture(eastLight.greenTex);
-        }
-        if (westLight.state != "GREEN") {
-            westLight.state = "GREEN";
-            westLight.lightSprite.setTexture(westLight.greenTex);
-        }
-        if (northLight.state != "RED") {
-            northLight.state = "RED";
-            northLight.lightSprite.setTexture(northLight.redTex);
-        }
-        if (southLight.state != "RED") {
-            southLight.state = "RED";
-            southLight.lightSprite.setTexture(southLight.redTex);
+    // Counts for one direction, indexed by VehicleType
+    void update(const int (&counts)[VEHICLE_TYPE_COUNT]) {
+        int newRegular = counts[static_cast<int>(VehicleType::REGULAR)];
+        int newEmergency = counts[static_cast<int>(VehicleType::EMERGENCY)];
+        int newHeavy = counts[static_cast<int>(VehicleType::HEAVY)];
+        if (newRegular == regular && newEmergency == emergency && newHeavy == heavy) {
+            return;
         }
-    } else if (elapsed < (cycleDuration / 2) + greenPhaseDuration + yellowDuration) {
-        // East-West YELLOW, North-South remains RED
-        if (eastLight.state != "YELLOW") {
-            eastLight.state = "YELLOW";
-            eastLight.lightSprite.setTexture(eastLight.yellowTex);
-        }
-        if (westLight.state != "YELLOW") {
-            westLight.state = "YELLOW";
-            westLight.lightSprite.setTexture(westLight.yellowTex);
-        }
-    } else {
-        // East-West RED, North-South remains RED
-        if (eastLight.state != "RED") {
-            eastLight.state = "RED";
-            eastLight.lightSprite.setTexture(eastLight.redTex);
-        }
-        if (westLight.state != "RED") {
-            westLight.state = "RED";
-            westLight.lightSprite.setTexture(westLight.redTex);
-        }
-    }
-}
-
-// Function to format the time as a string
-std::string formatTime(const std::time_t& time) {
-    char buffer[100];
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&time));
-    return std::string(buffer);
-}
-
-// Function to generate the current date as a string
-std::string getCurrentDate() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t now_time = std::chrono::system_clock::to_time_t(now);
-    return formatTime(now_time);
-}
-
-// Function to calculate the due date (3 days from now)
-std::string getDueDate(int daysToAdd = 3) {
-    auto now = std::chrono::system_clock::now();
-    auto due_time = now + std::chrono::hours(daysToAdd * 24);
-    std::time_t due_time_t = std::chrono::system_clock::to_time_t(due_time);
-    return formatTime(due_time_t);
-}
-
-int generateMockSpeed(std::string type) {
-    if (type == "E"){
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<> dist(1, 75);
-        return dist(gen);
-    }
-    else if (type == "R") {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<> dist(1, 55);
-        return dist(gen);
-    }
-    else {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<> dist(1, 35);
-        return dist(gen);
-    }
-    
-}
-
-// Function to generate a random plate number
-std::string generateRandomPlate() {
-    std::random_device rd;                  // Seed for random number generation
-    std::mt19937 gen(rd());                 // Mersenne Twister RNG
-    std::uniform_int_distribution<> charDist(0, 25); // Distribution for letters (A-Z)
-    std::uniform_int_distribution<> numDist(0, 9);   // Distribution for digits (0-9)
-
-    std::string plate;
-
-    // Generate 3 random uppercase letters
-    for (int i = 0; i < 3; ++i) {
-        char letter = 'A' + charDist(gen); // Convert to ASCII character
-        plate += letter;
+        regular = newRegular;
+        emergency = newEmergency;
+        heavy = newHeavy;
+        text.setString(
+            title + ":\n" +
+            std::to_string(regular) + " Regular\n" +
+            std::to_string(emergency) + " Emergency\n" +
+            std::to_string(heavy) + " Heavy\n"
+        );
     }
-
-    // Generate 3 random digits
-    for (int i = 0; i < 3; ++i) {
-        char digit = '0' + numDist(gen); // Convert to ASCII character
-        plate += digit;
-    }
-
-    return plate;
-}
-
-// Struct to represent a speed violation
-struct SpeedViolation {
-    std::string vehicleID;
-    std::string type;
-    float speed;
-    std::string direction;
-    std::string status; //"Active" or "Inactive"
 };
 
-struct Challan {
-    std::string challanID;
-    std::string vehicleID;
-    std::string status;
-    std::string issueDate;
-    std::string dueDate;
-    float payableAmount;
-};
-
-
-
-// Function to generate a random challan ID
-std::string generateChallanID() {
-    // Random number generator
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> charDist(0, 25); // Distribution for letters (A-Z)
-    std::uniform_int_distribution<> numDist(0, 9);   // Distribution for digits (0-9)
-
-    std::string challanID;
-
-    // Generate 2 random uppercase letters
-    for (int i = 0; i < 2; ++i) {
-        char letter = 'A' + charDist(gen); // Convert to ASCII character
-        challanID += letter;
-    }
-
-    // Generate 4 random digits
-    for (int i = 0; i < 4; ++i) {
-        char digit = '0' + numDist(gen); // Convert to ASCII character
-        challanID += digit;
+// Elapsed time and throughput, laid out again only when a shown number changes
+struct HudTimer {
+    sf::Text text;
+    int shownSeconds = -1, shownCleared = -1, shownThroughput = -1;
+    size_t shownDropped = 0;
+
+    // dropped is the number of violations the challan pipeline had no room for
+    void update(double elapsedTime, int cleared, int throughput, size_t dropped) {
+        int wholeSeconds = static_cast<int>(elapsedTime);
+        if (wholeSeconds == shownSeconds && cleared == shownCleared && throughput == shownThroughput &&
+            dropped == shownDropped) {
+            return;
+        }
+        shownSeconds = wholeSeconds;
+        shownCleared = cleared;
+        shownThroughput = throughput;
+        shownDropped = dropped;
+
+        int minutes = wholeSeconds / 60;
+        int seconds = wholeSeconds % 60;
+        std::string display = "Time Left: " + std::to_string(minutes) + "m " + std::to_string(seconds) + "s\n" +
+                              "Cleared: " + std::to_string(cleared) + " (" + std::to_string(throughput) + "/min)";
+        if (dropped > 0) {
+            display += "\nViolations dropped: " + std::to_string(dropped);
+        }
+        text.setString(display);
     }
+};
 
-    return challanID;
+// Sprite rotation for each direction of travel
+float rotationFor(Direction direction) {
+    if (direction == Direction::NORTH) return 180;
+    if (direction == Direction::EAST) return -90;
+    if (direction == Direction::WEST) return 90;
+    return 0;
 }
 
-// Shared resources
-std::queue<SpeedViolation> violationQueue;
-std::mutex queueMutex;
-std::condition_variable violationNotifier;
-bool stopChallanThread = false;
-std::queue<Challan> challans;
-
 // Function to display the user portal
-AppState showUserPortal(sf::RenderWindow& window, sf::Font& font) {
+AppState showUserPortal(sf::RenderWindow& window, const sf::Font& font) {
     std::string enteredVehicleID; // For capturing user input
     sf::Text inputText, resultText, promptText;
 
@@ -323,27 +183,29 @@ AppState showUserPortal(sf::RenderWindow& window, sf::Font& font) {
                     }
                 } else if (event.text.unicode == '\r') { // Handle enter
                     if (!enteredVehicleID.empty()) {
-                        std::queue<Challan> tempQueue = challans; // Make a copy of the queue for iteration
-                        bool found = false;
-
-                        while (!tempQueue.empty()) {
-                            const Challan& challan = tempQueue.front();
-                            if (challan.vehicleID == enteredVehicleID) {
-                                resultMessage = 
-                                    "Challan Found!\n"
-                                    "Challan ID: " + challan.challanID + "\n" +
-                                    "Vehicle ID: " + challan.vehicleID + "\n" +
-                                    "Status: " + challan.status + "\n" +
-                                    "Issue Date: " + challan.issueDate + "\n" +
-                                    "Due Date: " + challan.dueDate + "\n" +
-                                    "Amount: $" + std::to_string(challan.payableAmount);
-                                found = true;
-                                break;
+                        // Text that isn't a well-formed plate can't match anything
+                        PlateNumber plate;
+                        std::vector<Challan> found;
+                        if (parsePlate(enteredVehicleID, plate)) {
+                            found = challanStore.findByVehicleID(plate);
+                        }
+
+                        if (!found.empty()) {
+                            const Challan& challan = found.front();
+                            resultMessage = 
+                                "Challan Found!\n"
+                                "Challan ID: " + formatChallanNumber(challan.challanID) + "\n" +
+                                "Vehicle ID: " + formatPlate(challan.vehicleID) + "\n" +
+                                "Status: " + toString(challan.status) + "\n" +
+                                "Issue Date: " + formatTime(challan.issueTime) + "\n" +
+                                "Due Date: " + formatTime(challan.dueTime) + "\n" +
+                                "Amount: $" + std::to_string(challan.payableAmount);
+                            if (found.size() > 1) {
+                                resultMessage += "\n(" + std::to_string(found.size() - 1) + " more challans for this vehicle)";
                             }
-                            tempQueue.pop(); // Move to the next challan
                         }
 
-                        if (!found) {
+                        if (found.empty()) {
                             resultMessage = "No challan found for Vehicle ID: " + enteredVehicleID;
                         }
 
@@ -376,7 +238,7 @@ AppState showUserPortal(sf::RenderWindow& window, sf::Font& font) {
 
 }
 
-AppState showMenu(sf::RenderWindow& window, sf::Font& font) {
+AppState showMenu(sf::RenderWindow& window, const sf::Font& font) {
     // Menu options
     std::vector<std::string> options = {
         "Start Simulation",
@@ -443,7 +305,7 @@ AppState showMenu(sf::RenderWindow& window, sf::Font& font) {
 }
 
 
-AppState payChallan(sf::RenderWindow& window, sf::Font& font) {
+AppState payChallan(sf::RenderWindow& window, const sf::Font& font) {
     std::string enteredVehicleID, enteredChallanID, enteredAmount;
     sf::Text inputText, resultText, promptText, instructionsText;
 
@@ -513,30 +375,25 @@ AppState payChallan(sf::RenderWindow& window, sf::Font& font) {
                     currentField = "Amount";
                 } else if (currentField == "Amount" && !enteredAmount.empty()) {
                     // Perform the update operation
-                    std::queue<Challan> tempQueue;
-                    bool found = false;
-
-                    while (!challans.empty()) {
-                        Challan challan = challans.front();
-                        challans.pop();
-
-                        if (challan.vehicleID == enteredVehicleID && challan.challanID == enteredChallanID) {
-                            if (std::stod(enteredAmount) == challan.payableAmount) {
-                                challan.status = "Paid";
-                                resultMessage = "Challan status updated to 'Paid' successfully!";
-                                found = true;
-                            } else {
-                                resultMessage = "Invalid amount. Please enter the correct payable amount.";
-                                found = true;
-                            }
-                        }
-                        tempQueue.push(challan);
+                    PlateNumber plate;
+                    ChallanNumber challanNumber;
+                    PaymentResult result = PaymentResult::NOT_FOUND;
+                    if (parsePlate(enteredVehicleID, plate) && parseChallanNumber(enteredChallanID, challanNumber)) {
+                        result = challanStore.pay(plate, challanNumber, std::stod(enteredAmount));
                     }
-
-                    challans = tempQueue; // Restore the queue after processing
-
-                    if (!found) {
-                        resultMessage = "No matching challan found for the entered details.";
+                    switch (result) {
+                        case PaymentResult::PAID:
+                            resultMessage = "Challan status updated to 'Paid' successfully!";
+                            break;
+                        case PaymentResult::WRONG_AMOUNT:
+                            resultMessage = "Invalid amount. Please enter the correct payable amount.";
+                            break;
+                        case PaymentResult::NOT_FOUND:
+                            resultMessage = "No matching challan found for the entered details.";
+                            break;
+                        case PaymentResult::ALREADY_PAID:
+                            resultMessage = "This challan has already been paid.";
+                            break;
                     }
 
                     resultText.setString(resultMessage);
@@ -573,56 +430,11 @@ AppState payChallan(sf::RenderWindow& window, sf::Font& font) {
 
 
 
-// Challan processing function
-void challanProcessor() {
-    while (true) {
-        std::unique_lock<std::mutex> lock(queueMutex);
-
-        // Wait for a notification or stop signal
-        violationNotifier.wait(lock, [] { return !violationQueue.empty() || stopChallanThread; });
+// Layout of the challan status list
+const float CHALLAN_LIST_TOP = 120.0f;
+const float CHALLAN_ROW_HEIGHT = 40.0f;
 
-        if (stopChallanThread && violationQueue.empty()) {
-            break; // Exit the thread if stop signal is received
-        }
-
-        // Process all violations in the queue
-        while (!violationQueue.empty()) {
-            SpeedViolation violation = violationQueue.front();
-            float amount = 0;
-            if (violation.type == "R")
-            {
-                amount = 5000 + 0.17*5000;
-            }
-            else if (violation.type == "H")
-            {
-                amount = 7000 + 0.17*7000;
-            }
-
-            Challan challan = {
-                generateChallanID(),
-                violation.vehicleID,
-                violation.status,
-                getCurrentDate(),
-                getDueDate(),
-                amount
-            };
-            challans.push(challan);
-
-            violationQueue.pop();
-            lock.unlock(); // Unlock while processing to allow main thread to add more
-
-            // Simulate challan processing
-            std::cout << "Processing challan for Vehicle: " << violation.vehicleID
-                    << " | Speed: " << violation.speed
-                    << " | Direction: " << violation.direction << std::endl;
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(500)); // Simulate processing delay
-            lock.lock(); // Re-lock to access the queue
-        }
-    }
-}
-
-void showChallanStatuses(sf::RenderWindow& window, sf::Font& font) {
+void showChallanStatuses(sf::RenderWindow& window, const sf::Font& font) {
     sf::Text title;
     title.setFont(font);
     title.setString("Challan Statuses:");
@@ -630,30 +442,22 @@ void showChallanStatuses(sf::RenderWindow& window, sf::Font& font) {
     title.setFillColor(sf::Color::White);
     title.setPosition(50, 50);
 
-    // Generate challan list
-    std::vector<sf::Text> challanTexts;
-    std::queue<Challan> tempQueue = challans; // Copy the original queue
-
-    int yOffset = 120;
-    while (!tempQueue.empty()) {
-        const auto& challan = tempQueue.front();
-
-        // Prepare text for the challan
-        sf::Text text;
+    // Only the rows that fit on screen get an sf::Text. Challan i is shown by row i % rows, which
+    // is only formatted again when a different challan scrolls into it, so a frame costs the
+    // same however many challans the store holds.
+    ChallanStore::Snapshot snapshot = challanStore.snapshot();
+    float windowHeight = static_cast<float>(window.getSize().y);
+    size_t rowCount = static_cast<size_t>((windowHeight - CHALLAN_LIST_TOP) / CHALLAN_ROW_HEIGHT) + 2;
+    std::vector<sf::Text> rowTexts(rowCount);
+    std::vector<size_t> rowChallan(rowCount, snapshot->size()); // Snapshot index each row shows, size() for none
+    for (sf::Text& text : rowTexts) {
         text.setFont(font);
-        text.setString("ID: " + challan.challanID + " | Vehicle: " + challan.vehicleID + 
-                       " | Status: " + challan.status + " | Due: " + challan.dueDate +
-                       " | Amount: $" + std::to_string(challan.payableAmount));
         text.setCharacterSize(22);
         text.setFillColor(sf::Color::White);
-        text.setPosition(20, yOffset);
-
-        challanTexts.push_back(text);
-
-        yOffset += 40;
-        tempQueue.pop(); // Remove the processed challan from the temporary queue
     }
 
+    float listEnd = CHALLAN_LIST_TOP + snapshot->size() * CHALLAN_ROW_HEIGHT;
+    float maxScroll = std::max(0.0f, listEnd - windowHeight + 50);
     float scrollOffset = 0.0f; // Initial scroll position
 
     // Display challan statuses
@@ -669,20 +473,29 @@ void showChallanStatuses(sf::RenderWindow& window, sf::Font& font) {
                 if (event.mouseWheelScroll.delta > 0) { // Scroll up
                     scrollOffset = std::min(scrollOffset + 20.0f, 0.0f);
                 } else if (event.mouseWheelScroll.delta < 0) { // Scroll down
-                    scrollOffset = std::max(scrollOffset - 20.0f, -static_cast<float>(yOffset - window.getSize().y + 50));
+                    scrollOffset = std::max(scrollOffset - 20.0f, -maxScroll);
                 }
             }
         }
 
-        // Adjust positions based on the scroll offset
-        for (size_t i = 0; i < challanTexts.size(); ++i) {
-            challanTexts[i].setPosition(20, 120 + i * 40 + scrollOffset);
-        }
-
         window.clear(sf::Color::Black);
         window.draw(title);
-        for (const auto& text : challanTexts) {
-            if (text.getPosition().y > 50 && text.getPosition().y < window.getSize().y) { // Only draw visible items
+
+        // Lay out the challans from the first one at or below the top of the list
+        size_t first = static_cast<size_t>(-scrollOffset / CHALLAN_ROW_HEIGHT);
+        size_t last = std::min(first + rowCount, snapshot->size());
+        for (size_t i = first; i < last; ++i) {
+            size_t row = i % rowCount;
+            sf::Text& text = rowTexts[row];
+            if (rowChallan[row] != i) {
+                const Challan& challan = (*snapshot)[i];
+                text.setString("ID: " + formatChallanNumber(challan.challanID) + " | Vehicle: " + formatPlate(challan.vehicleID) +
+                               " | Status: " + toString(challan.status) + " | Due: " + formatTime(challan.dueTime) +
+                               " | Amount: $" + std::to_string(challan.payableAmount));
+                rowChallan[row] = i;
+            }
+            text.setPosition(20, CHALLAN_LIST_TOP + i * CHALLAN_ROW_HEIGHT + scrollOffset);
+            if (text.getPosition().y > 50 && text.getPosition().y < windowHeight) { // Only draw visible items
                 window.draw(text);
             }
         }
@@ -691,124 +504,431 @@ void showChallanStatuses(sf::RenderWindow& window, sf::Font& font) {
 }
 
 
-// IMPORTANT NOTES:
-// I have used the scale of 1s in real life = 3s in my simulation for the spawning cars. As the sprites overlap if a wait of 1s is given
+// Run the simulation with no window as fast as possible and print a summary
+int runHeadless(const SimConfig& config, float timestep, bool profile, const std::string& profileCsvPath) {
+    IntersectionSim sim(config);
+    StageProfiler profiler;
+    if (profile) {
+        sim.setProfiler(&profiler);
+    }
 
-int main() {
-    // Initialize intersection and SFML window
-    sf::RenderWindow window(sf::VideoMode(1000, 1000), "Smart Traffic Simulation");
+    auto wallStart = std::chrono::steady_clock::now();
+    while (!sim.isFinished()) {
+        sim.step(timestep);
+    }
+    std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - wallStart;
+
+    const SimStats& stats = sim.getStats();
+    std::cout << "Headless simulation complete!" << std::endl;
+    std::cout << "Simulated time: " << sim.getElapsedTime() << "s"
+              << " | Wall time: " << wallTime.count() << "s" << std::endl;
+    std::cout << "Vehicles spawned: " << stats.vehiclesSpawned
+              << " | Cleared: " << stats.vehiclesCleared
+              << " (" << sim.getThroughputPerMinute() << "/min)"
+              << " | Still active: " << sim.getVehicles().size()
+              << " | Speed violations: " << stats.violations << std::endl;
+    std::cout << "Signals: " << sim.getSignalController().getName()
+              << " | Average delay: " << sim.getAverageDelay() << "s per vehicle" << std::endl;
+    std::cout << "Vehicle-steps: " << stats.vehicleSteps
+              << " (" << stats.vehicleSteps / wallTime.count() << "/s, "
+              << integrationKernelName() << " integration)" << std::endl;
+
+    const VehicleCounts& counts = sim.getVehicleCounts();
+    std::cout << "Queued: " << counts.total(counts.queued)
+              << " | Approaching: " << counts.total(counts.approaching)
+              << " | Departing: " << counts.total(counts.departing) << std::endl;
+    for (int d = 0; d < DIRECTION_COUNT; ++d) {
+        Direction direction = static_cast<Direction>(d);
+        const int* approaching = counts.approaching[d];
+        std::cout << "  " << toString(direction) << ": queued " << counts.total(counts.queued, direction)
+                  << ", approaching " << approaching[static_cast<int>(VehicleType::REGULAR)] << "R/"
+                  << approaching[static_cast<int>(VehicleType::HEAVY)] << "H/"
+                  << approaching[static_cast<int>(VehicleType::EMERGENCY)] << "E" << std::endl;
+    }
 
-    AppState state = AppState::MENU;
-    // Vehicle count by type for each direction
-    int northRegularCount = 0, northEmergencyCount = 0, northHeavyCount = 0;
-    int southRegularCount = 0, southEmergencyCount = 0, southHeavyCount = 0;
-    int eastRegularCount = 0, eastEmergencyCount = 0, eastHeavyCount = 0;
-    int westRegularCount = 0, westEmergencyCount = 0, westHeavyCount = 0;
+    if (profile) {
+        std::cout << "Stage timings over the last " << profiler.getTiming(Stage::MOVE).samples << " steps:\n"
+                  << profiler.formatTable();
+        if (!profileCsvPath.empty()) {
+            profiler.writeCsv(profileCsvPath);
+        }
+    }
+    return 0;
+}
 
-    // Load the background texture
-    sf::Texture backgroundTexture;
-    if (!backgroundTexture.loadFromFile("img/Intersection6.png")) {
-        std::cerr << "Error: Could not load img/Intersection.png" << std::endl;
-        return -1;
+// Headless run of a grid of linked intersections (--network)
+int runNetwork(const NetworkConfig& networkConfig) {
+    RoadNetwork network(networkConfig);
+
+    auto wallStart = std::chrono::steady_clock::now();
+    network.run();
+    std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - wallStart;
+
+    NetworkStats stats = network.getStats();
+    double minutes = network.getElapsedTime() / 60.0;
+    std::cout << "Network simulation complete!" << std::endl;
+    std::cout << "Grid: " << networkConfig.rows << "x" << networkConfig.columns << " intersections, "
+              << network.getSegments().size() << " road segments, " << network.getThreadCount() << " threads" << std::endl;
+    std::cout << "Simulated time: " << network.getElapsedTime() << "s"
+              << " | Wall time: " << wallTime.count() << "s" << std::endl;
+    std::cout << "Vehicles spawned: " << stats.vehiclesSpawned
+              << " | Exited: " << stats.vehiclesExited << " (" << (minutes > 0 ? stats.vehiclesExited / minutes : 0.0) << "/min)"
+              << " | Hand-overs: " << stats.handOvers
+              << " | In transit: " << stats.inTransit
+              << " | Speed violations: " << stats.violations << std::endl;
+    std::cout << "Average delay: " << stats.getAverageDelay() << "s per vehicle" << std::endl;
+    for (size_t i = 0; i < network.getIntersectionCount(); ++i) {
+        const IntersectionSim& sim = network.getIntersection(i);
+        const SimStats& simStats = sim.getStats();
+        std::cout << "  [" << i / networkConfig.columns << "," << i % networkConfig.columns << "]"
+                  << " spawned " << simStats.vehiclesSpawned
+                  << ", arrived " << simStats.vehiclesArrived
+                  << ", cleared " << simStats.vehiclesCleared
+                  << " (" << sim.getThroughputPerMinute() << "/min)"
+                  << ", on road " << sim.getVehicles().size() << std::endl;
     }
-    sf::Sprite backgroundSprite;
-    backgroundSprite.setTexture(backgroundTexture);
-    //backgroundSprite.setScale(1.25f, 1.25f);
+    return 0;
+}
+
+// Headless Monte Carlo run of seeded replications (--batch)
+int runBatch(const BatchConfig& batchConfig, const std::string& outputPath) {
+    BatchRunner runner(batchConfig);
 
-    // Load vehicle texture
-    // Load textures for regular, emergency, and heavy vehicles
-    sf::Texture regularCarTexture, emergencyCarTexture, heavyCarTexture;
-    if (!regularCarTexture.loadFromFile("img/RegularCar2.png") ||
-        !emergencyCarTexture.loadFromFile("img/EmergencyCar.png") ||
-        !heavyCarTexture.loadFromFile("img/Truck.png")) {
-        std::cerr << "Error: Could not load vehicle textures" << std::endl;
+    auto wallStart = std::chrono::steady_clock::now();
+    runner.run();
+    std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - wallStart;
+
+    std::cout << "Batch complete: " << batchConfig.replications << " replications of "
+              << batchConfig.scenario.duration << "s (seeds " << batchConfig.baseSeed << "-"
+              << batchConfig.baseSeed + batchConfig.replications - 1 << ") on " << runner.getThreadCount()
+              << " threads | Wall time: " << wallTime.count() << "s" << std::endl;
+    std::cout << runner.formatTable();
+    if (!runner.writeCsv(outputPath)) {
         return -1;
     }
-    
-    // Queues for each direction
-    std::queue<VehicleSprite> northQueue;
-    std::queue<VehicleSprite> southQueue;
-    std::queue<VehicleSprite> eastQueue;
-    std::queue<VehicleSprite> westQueue;
-    
-    // List to hold active vehicle sprites
-    std::vector<VehicleSprite> vehicles;
-
-    // Sprites for the traffic lights
-    sf::Texture redLightTex, greenLightTex, YellowLightTex;
-    if (!redLightTex.loadFromFile("img/redlight.png") ||
-        !YellowLightTex.loadFromFile("img/yellowLight.png") ||
-        !greenLightTex.loadFromFile("img/greenLight.png")) {
-        std::cerr << "Error: Could not load traffic textures" << std::endl;
+    std::cout << "Results written to " << outputPath << std::endl;
+    return 0;
+}
+
+// Option values must be a whole, in-range number. These return false instead of throwing
+// like std::stof and friends, so a bad value ends up at the usage text.
+bool parseNumber(const char* text, float& value) {
+    char* end = nullptr;
+    errno = 0;
+    float parsed = std::strtof(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE || !std::isfinite(parsed)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool parseNumber(const char* text, long& value) {
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool parseNumber(const char* text, int& value) {
+    long parsed;
+    if (!parseNumber(text, parsed) || parsed < INT_MIN || parsed > INT_MAX) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+bool parseNumber(const char* text, unsigned int& value) {
+    long parsed;
+    if (!parseNumber(text, parsed) || parsed < 0 || parsed > static_cast<long>(UINT_MAX)) {
+        return false;
+    }
+    value = static_cast<unsigned int>(parsed);
+    return true;
+}
+
+bool parseNumber(const char* text, size_t& value) {
+    long parsed;
+    if (!parseNumber(text, parsed) || parsed < 0) {
+        return false;
+    }
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--headless] [--duration <seconds>] [--seed <n>] [--signals fixed|actuated] [--signal-plan <path>]"
+              << " [--network <rows>x<cols>] [--network-threads <n>] [--segment-time <seconds>]"
+              << " [--batch <replications>] [--batch-threads <n>] [--batch-out <path>]"
+              << " [--timestep <seconds>] [--time-scale <factor> | --fast]"
+              << " [--violation-buffer <n>] [--overflow block|drop|count]"
+              << " [--challan-workers <n>] [--challan-latency <ms>] [--ledger <path>]"
+              << " [--hud-rate <hz>] [--log-level debug|info|warn|error|off] [--event-log <path>]"
+              << " [--profile] [--profile-csv <path>]" << std::endl;
+    std::cerr << "--duration, --segment-time, --timestep and --time-scale take positive numbers" << std::endl;
+}
+
+// IMPORTANT NOTES:
+// I have used the scale of 1s in real life = 3s in my simulation for the spawning cars. As the sprites overlap if a wait of 1s is given
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    bool headless = false;
+    float timestep = 1.0f / 60.0f;
+    float timeScale = 1.0f;
+    size_t violationBuffer = 4096;
+    OverflowPolicy overflowPolicy = OverflowPolicy::COUNT;
+    int challanWorkers = std::max(1u, std::thread::hardware_concurrency());
+    int challanLatencyMs = 0;
+    std::string ledgerPath = "challans.log";
+    float hudRate = 0.0f;
+    LogLevel logLevel = LogLevel::INFO;
+    std::string eventLogPath;
+    bool profile = false;
+    std::string profileCsvPath;
+    std::string signalPlanPath;
+    NetworkConfig networkConfig;
+    bool network = false;
+    BatchConfig batchConfig;
+    bool batch = false;
+    std::string batchOutputPath = "batch_results.csv";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc &&
+                   parseNumber(argv[i + 1], config.duration) && config.duration > 0.0f) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc && parseNumber(argv[i + 1], config.seed)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--signals") == 0 && i + 1 < argc && parseSignalControl(argv[i + 1], config.signalControl)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--signal-plan") == 0 && i + 1 < argc) {
+            signalPlanPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--network") == 0 && i + 1 < argc &&
+                   std::sscanf(argv[i + 1], "%dx%d", &networkConfig.rows, &networkConfig.columns) == 2) {
+            network = true;
+            ++i;
+        } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc && parseNumber(argv[i + 1], batchConfig.replications)) {
+            batch = true;
+            ++i;
+        } else if (std::strcmp(argv[i], "--batch-threads") == 0 && i + 1 < argc && parseNumber(argv[i + 1], batchConfig.threads)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--batch-out") == 0 && i + 1 < argc) {
+            batchOutputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--network-threads") == 0 && i + 1 < argc && parseNumber(argv[i + 1], networkConfig.threads)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--segment-time") == 0 && i + 1 < argc &&
+                   parseNumber(argv[i + 1], networkConfig.segmentTravelTime) && networkConfig.segmentTravelTime > 0.0f) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--timestep") == 0 && i + 1 < argc && parseNumber(argv[i + 1], timestep) && timestep > 0.0f) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--time-scale") == 0 && i + 1 < argc && parseNumber(argv[i + 1], timeScale) && timeScale > 0.0f) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--fast") == 0) {
+            timeScale = 0.0f;
+        } else if (std::strcmp(argv[i], "--violation-buffer") == 0 && i + 1 < argc && parseNumber(argv[i + 1], violationBuffer)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--challan-workers") == 0 && i + 1 < argc && parseNumber(argv[i + 1], challanWorkers)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--challan-latency") == 0 && i + 1 < argc && parseNumber(argv[i + 1], challanLatencyMs)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--log-level") == 0 && i + 1 < argc && parseLogLevel(argv[i + 1], logLevel)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--event-log") == 0 && i + 1 < argc) {
+            eventLogPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (std::strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc) {
+            profile = true;
+            profileCsvPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--hud-rate") == 0 && i + 1 < argc && parseNumber(argv[i + 1], hudRate)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--ledger") == 0 && i + 1 < argc) {
+            ledgerPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--overflow") == 0 && i + 1 < argc) {
+            std::string policy = argv[++i];
+            overflowPolicy = policy == "block" ? OverflowPolicy::BLOCK
+                           : policy == "drop" ? OverflowPolicy::DROP
+                           : OverflowPolicy::COUNT;
+        } else {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+
+    // A plan is a fixed-time schedule, the actuated controller has no use for one
+    if (!signalPlanPath.empty() && config.signalControl == SignalControl::ACTUATED) {
+        std::cerr << "Error: --signal-plan only applies to --signals fixed" << std::endl;
+        printUsage(argv[0]);
         return -1;
     }
 
-    TrafficLight northLight(redLightTex, YellowLightTex, greenLightTex, 4.0f, 2.0f, 7.0f);
-    TrafficLight southLight(redLightTex, YellowLightTex, greenLightTex, 4.0f, 2.0f, 7.0f);
-    TrafficLight eastLight(redLightTex, YellowLightTex, greenLightTex, 4.0f, 2.0f, 7.0f);
-    TrafficLight westLight(redLightTex, YellowLightTex, greenLightTex, 4.0f, 2.0f, 7.0f);
+    if (!signalPlanPath.empty()) {
+        auto plan = std::make_shared<SignalPlan>();
+        if (!plan->load(signalPlanPath)) {
+            return -1;
+        }
+        config.signalPlan = plan;
+    }
 
-    northLight.lightSprite.setPosition(505, 348);
-    northLight.lightSprite.setScale(0.1f, 0.1f);
-    northLight.lightSprite.rotate(180);
+    if (!startLogger(logLevel, eventLogPath)) {
+        return -1;
+    }
+    LoggerGuard loggerGuard;
+
+    // Replications are seeded from --seed (or one random base seed) so a batch can be rerun
+    if (batch) {
+        batchConfig.scenario = config;
+        batchConfig.timestep = timestep;
+        batchConfig.baseSeed = config.seed != 0 ? config.seed : std::random_device{}();
+        return runBatch(batchConfig, batchOutputPath);
+    }
 
+    // Networks are headless only, the window draws a single intersection
+    if (network) {
+        networkConfig.intersection = config;
+        networkConfig.timestep = timestep;
+        return runNetwork(networkConfig);
+    }
 
-    southLight.lightSprite.setPosition(467, 648);
-    southLight.lightSprite.setScale(0.1f, 0.1f);
+    if (headless) {
+        return runHeadless(config, timestep, profile, profileCsvPath);
+    }
 
-    eastLight.lightSprite.setPosition(645, 520);
-    eastLight.lightSprite.setScale(0.1f, 0.1f);
-    eastLight.lightSprite.rotate(-90);
-    
-    westLight.lightSprite.setPosition(345, 482);
-    westLight.lightSprite.setScale(0.1f, 0.1f);
-    westLight.lightSprite.rotate(+90);
+    // Start decoding every image and the font now. They load in parallel in the background
+    // while the ledger is replayed and the window opens.
+    AssetManager assets;
+    assets.preloadImages(ATLAS_IMAGES);
+    assets.preloadImages({ BACKGROUND_IMAGE });
+    assets.preloadFont(FONT_PATH);
+
+    // Recover challans from earlier runs. Payments are folded into their challans and the
+    // log rewritten without them, so it only grows with new challans.
+    ChallanLedger ledger(ledgerPath);
+    std::vector<Challan> recovered;
+    size_t recoveredPayments = 0;
+    if (!ledger.replay(recovered, recoveredPayments)) {
+        return -1;
+    }
+    if (recoveredPayments > 0 && !ledger.compact(recovered)) {
+        // Whichever log is in place still holds every challan, the payments are folded again next start
+        logMessage(LogLevel::WARN, "Continuing with the uncompacted ledger " + ledgerPath);
+    }
+    std::cout << "Recovered " << recovered.size() << " challans from " << ledgerPath << std::endl;
+    resumeChallanIDs(countChallanIDsUsed(recovered));
+    challanStore.load(std::move(recovered));
+    if (ledger.open()) {
+        challanStore.setLedger(&ledger);
+    }
 
+    // Initialize SFML window
+    sf::RenderWindow window(sf::VideoMode(1000, 1000), "Smart Traffic Simulation");
 
-    // Clock for simulation timing for each direction
-    sf::Clock northClock, southClock, eastClock, westClock, heavyCarClock;
+    AppState state = AppState::MENU;
 
-    // Separate timers for emergency cars
-    sf::Clock northEmergencyClock, southEmergencyClock, eastEmergencyClock, westEmergencyClock;
-    bool northEmergency, southEmergency, eastEmergency, westEmergency;
-    northEmergency = southEmergency = eastEmergency = westEmergency = false;
+    // Load the background texture
+    AssetHandle<sf::Texture> backgroundTexture = assets.getTexture(BACKGROUND_IMAGE);
+    if (!backgroundTexture) {
+        return -1;
+    }
+    sf::Sprite backgroundSprite;
+    backgroundSprite.setTexture(*backgroundTexture);
+    //backgroundSprite.setScale(1.25f, 1.25f);
 
-    // Random number generator for probabilities
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0.0, 1.0);
+    // Vehicles and traffic lights share one atlas texture and are drawn in a single batch
+    TextureAtlas atlas;
+    if (!atlas.build(assets, ATLAS_IMAGES)) {
+        std::cerr << "Error: Could not load vehicle and traffic light textures" << std::endl;
+        return -1;
+    }
+    SpriteBatch spriteBatch(atlas.getTexture());
+
+    // Simulation engine, the window only reads its state
+    IntersectionSim sim(config);
+    ViolationPipeline violationPipeline(violationBuffer, overflowPolicy);
+    sim.setViolationHandler([&violationPipeline, &sim](const SpeedViolation& violation) {
+        logViolation(violation, sim.getElapsedTime());
+        // Hand the violation to the challan thread, this never blocks unless the policy is BLOCK
+        violationPipeline.submit(violation);
+    });
+
+    // Traffic lights
+    TrafficLight northLight(atlas);
+    TrafficLight southLight(atlas);
+    TrafficLight eastLight(atlas);
+    TrafficLight westLight(atlas);
+
+    northLight.placement.setPosition(505, 348);
+    northLight.placement.setScale(0.1f, 0.1f);
+    northLight.placement.rotate(180);
+
+
+    southLight.placement.setPosition(467, 648);
+    southLight.placement.setScale(0.1f, 0.1f);
+
+    eastLight.placement.setPosition(645, 520);
+    eastLight.placement.setScale(0.1f, 0.1f);
+    eastLight.placement.rotate(-90);
     
-    sf::Clock moveClock;
+    westLight.placement.setPosition(345, 482);
+    westLight.placement.setScale(0.1f, 0.1f);
+    westLight.placement.rotate(+90);
 
-    sf::Clock trafficCycleClock;
-    float cycleDuration = 25.0f; // Total duration for one complete cycle (e.g., 10 seconds)
+    // Real time between frames is converted into fixed simulation steps
+    sf::Clock moveClock;
+    SimClock simClock(timestep, timeScale);
 
     // Load font for timer
-    sf::Font font;
-    if (!font.loadFromFile("fonts/fonty_font.ttf")) { // Replace with the path to your font file
-        std::cerr << "Error: Could not load font!" << std::endl;
+    AssetHandle<sf::Font> fontHandle = assets.getFont(FONT_PATH);
+    if (!fontHandle) {
         return -1;
     }
+    const sf::Font& font = *fontHandle;
+
+    // The decoded images have been uploaded, only the GPU copies are needed from here on
+    assets.trim();
 
     // Timer text
-    sf::Text timerText;
-    timerText.setFont(font);
-    timerText.setCharacterSize(24);
-    timerText.setFillColor(sf::Color::White);
-    timerText.setPosition(5, 700); // Top-left corner
-
-    sf::Clock simulationClock;
-    const float simulationDuration = 300.0f; // 5 minutes in seconds
-    float elapsedTime;
+    HudTimer timer;
+    timer.text.setFont(font);
+    timer.text.setCharacterSize(24);
+    timer.text.setFillColor(sf::Color::White);
+    timer.text.setPosition(5, 700); // Top-left corner
+
+    // Vehicle counts for each approach
+    HudPanel northPanel(font, "North", 750, 10); // Top-right corner
+    HudPanel southPanel(font, "South", 10, 900); // Bottom-left corner
+    HudPanel eastPanel(font, "East", 750, 900);  // Bottom-right corner
+    HudPanel westPanel(font, "West", 10, 10);    // Top-left corner
+
+    sf::Vector2i lastMousePosition(-1, -1);
+
+    // Stage timings, always collected in the window. F2 shows them, F3 writes the CSV.
+    StageProfiler profiler;
+    sim.setProfiler(&profiler);
+    bool showProfiler = false;
+    sf::Clock profilerClock;
+    sf::Text profilerText;
+    profilerText.setFont(font);
+    profilerText.setCharacterSize(16);
+    profilerText.setFillColor(sf::Color::Yellow);
+    profilerText.setPosition(300, 10);
+
+    // With --hud-rate the HUD is refreshed at most that many times per second
+    sf::Clock hudClock;
+    float hudInterval = hudRate > 0.0f ? 1.0f / hudRate : 0.0f;
 
-    sf::Clock speedTimer;
-    
-    
+    float elapsedTime;
 
     bool isSimulation = false;
 
-    // Initiate the challan thread
-    std::thread challanThread(challanProcessor);
+    // Start the challan workers
+    ChallanWorkerPool challanPool(violationPipeline, challanWorkers, std::chrono::milliseconds(challanLatencyMs));
 
     while (state != AppState::EXIT)
     {
@@ -819,8 +939,11 @@ int main() {
         else if (state == AppState::SIMULATION)
         {
             isSimulation = true;
+            moveClock.restart(); // Don't count the time spent in the menu
+            simClock.reset();
             
             while (window.isOpen() && isSimulation) {
+            ScopedStageTimer frameTimer(&profiler, Stage::FRAME);
             sf::Event event;
 
             while (window.pollEvent(event)) {
@@ -830,914 +953,123 @@ int main() {
                     break;                 
                 }
 
-                if (event.type == sf::Event::Closed){
-                    window.close();
+                // F1 switches debug output (mouse coordinates) on and off
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F1) {
+                    setLogLevel(getLogLevel() == LogLevel::DEBUG ? LogLevel::INFO : LogLevel::DEBUG);
                 }
-            }
-
-            // Calculate remaining time
-            elapsedTime = simulationClock.getElapsedTime().asSeconds();
 
-            if (elapsedTime >= 500.0f) {
-                std::cout << "Simulation complete!" << std::endl;
-                window.close(); // Exit the simulation after 5 minutes
-                break;
-            }
-
-            // Spawn emergency vehicles
-            // Max speed = 80km/hr
-            if (northEmergencyClock.getElapsedTime().asSeconds() >= 15.0f && dis(gen) < 0.2) {
-                VehicleSprite vehicle;
-                vehicle.sprite.setTexture(emergencyCarTexture);
-                vehicle.plateNumber = generateRandomPlate();
-                vehicle.sprite.setPosition(NORTH_SPAWN_REGULAR_LANE1);
-                vehicle.sprite.setRotation(180);
-                vehicle.direction = "NORTH";
-                vehicle.speed = 30.0f;
-                vehicle.type = "E";
-                vehicle.hasTurned = false;
-                vehicle.mockSpeed = generateMockSpeed(vehicle.type);
-                northQueue.push(vehicle);
-                northEmergency = true;
-                northEmergencyClock.restart();
-            }
-
-            if (southEmergencyClock.getElapsedTime().asSeconds() >= 6.0f && dis(gen) < 0.05) {
-                VehicleSprite vehicle;
-                vehicle.sprite.setTexture(emergencyCarTexture);
-                vehicle.plateNumber = generateRandomPlate();
-                vehicle.sprite.setPosition(SOUTH_SPAWN_REGULAR_LANE1);
-                vehicle.direction = "SOUTH";
-                vehicle.speed = 30.0f;
-                vehicle.hasTurned = false;
-                vehicle.type = "E";
-                vehicle.mockSpeed = generateMockSpeed(vehicle.type);
-                southQueue.push(vehicle);
-                southEmergency = true;
-                southEmergencyClock.restart();
-            }
-
-            if (eastEmergencyClock.getElapsedTime().asSeconds() >= 20.0f && dis(gen) < 0.1) {
-                VehicleSprite vehicle;
-                vehicle.sprite.setTexture(emergencyCarTexture);
-                vehicle.plateNumber = generateRandomPlate();
-                vehicle.sprite.setPosition(EAST_SPAWN_REGULAR_LANE1);
-                vehicle.sprite.setRotation(-90);
-                vehicle.direction = "EAST";
-                vehicle.speed = 30.0f;
-                vehicle.hasTurned = false;
-                vehicle.type = "E";
-                vehicle.mockSpeed = generateMockSpeed(vehicle.type);
-                eastQueue.push(vehicle);
-                eastEmergency = true;
-                eastEmergencyClock.restart();
-            }
-
-            if (westEmergencyClock.getElapsedTime().asSeconds() >= 6.0f && dis(gen) < 0.3) {
-                VehicleSprite vehicle;
-                vehicle.sprite.setTexture(emergencyCarTexture);
-                vehicle.plateNumber = generateRandomPlate();
-                vehicle.sprite.setPosition(WEST_SPAWN_REGULAR_LANE1);
-                vehicle.sprite.setRotation(90);
-                vehicle.direction = "WEST";
-                vehicle.speed = 30.0f;
-                vehicle.type = "E";
-                vehicle.hasTurned = false;
-                vehicle.mockSpeed = generateMockSpeed(vehicle.type);
-                westQueue.push(vehicle);
-                westEmergency = true;
-                westEmergencyClock.restart();
-            }
-
-            // Spawn regular vehicles from each direction at their respective intervals
-            if (northClock.getElapsedTime().asSeconds() >= 3.0f && !northEmergency) {
-                VehicleSprite vehicle;
-                vehicle.sprite.setTexture(regularCarTexture);
-                vehicle.sprite.setPosition(NORTH_SPAWN_REGULAR_LANE1);
-                vehicle.sprite.setRotation(180);
-                vehicle.plateNumber = generateRandomPlate();
-                vehicle.direction = "NORTH";
-                vehicle.speed = 30.0f;
-                vehicle.type = "R";
-                vehicle.hasTurned = false;
-                vehicle.mockSpeed = generateMockSpeed(vehicle.type);
-                northQueue.push(vehicle);
-                northClock.restart();
-            }
-
-            if (southClock.getElapsedTime().asSeconds() >= 4.0f && !southEmergency) {
-                VehicleSprite vehicle;
-                vehicle.sprite.setTexture(regularCarTexture);
-                vehicle.plateNumber = generateRandomPlate();
-                vehicle.sprite.setPosition(SOUTH_SPAWN_REGULAR_LANE1);
-                vehicle.direction = "SOUTH";
-                vehicle.speed = 30.0f;
-                vehicle.hasTurned = false;
-                vehicle.type = "R";
-                vehicle.mockSpeed = generateMockSpeed(vehicle.type);
-                southQueue.push(vehicle);
-                southClock.restart();
-            }
-
-            if (eastClock.getElapsedTime().asSeconds() >= 3.5f && !eastEmergency) {
-                VehicleSprite vehicle;
-                vehicle.sprite.setTexture(regularCarTexture);
-                vehicle.plateNumber = generateRandomPlate();
-                vehicle.sprite.setPosition(EAST_SPAWN_REGULAR_LANE1);
-                vehicle.sprite.setRotation(-90);
-                vehicle.direction = "EAST";
-                vehicle.speed = 30.0f;
-                vehicle.type = "R";
-                vehicle.hasTurned = false;
-                vehicle.mockSpeed = generateMockSpeed(vehicle.type);
-                eastQueue.push(vehicle);
-                eastClock.restart();
-            }
-
-            if (westClock.getElapsedTime().asSeconds() >= 4.0f && !westEmergency) {
-                VehicleSprite vehicle;
-                vehicle.sprite.setTexture(regularCarTexture);
-                vehicle.sprite.setPosition(WEST_SPAWN_REGULAR_LANE1);
-                vehicle.plateNumber = generateRandomPlate();
-                vehicle.sprite.setRotation(90);
-                vehicle.direction = "WEST";
-                vehicle.speed = 30.0f;
-                vehicle.hasTurned = false;
-                vehicle.type = "R";
-                vehicle.mockSpeed = generateMockSpeed(vehicle.type);
-                westQueue.push(vehicle);
-                westClock.restart();
-            }
-            int northCount, southCount, eastCount, westCount;
-            northCount = southCount = eastCount = westCount = 0;
-
-            for (const auto& vehicle : vehicles)
-            {
-                if (vehicle.direction == "NORTH" && !vehicle.hasTurned)
-                {
-                    northCount++;
-                }
-                else if (vehicle.direction == "SOUTH" && !vehicle.hasTurned)
-                {
-                    southCount++;
+                // F2 shows the stage timings, F3 writes them to the CSV file
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F2) {
+                    showProfiler = !showProfiler;
+                    profilerClock.restart();
+                    profilerText.setString(profiler.formatTable());
                 }
-                else if (vehicle.direction == "EAST" && !vehicle.hasTurned)
-                {
-                    eastCount++;
-                }
-                else if (vehicle.direction == "WEST" && !vehicle.hasTurned)
-                {
-                    westCount++;
-                }
-            }
-
-            if (northCount <= 6)
-            {
-                if (!northQueue.empty()){
-                    vehicles.push_back(northQueue.front());
-                    northQueue.pop();
+                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3) {
+                    std::string path = profileCsvPath.empty() ? "profile.csv" : profileCsvPath;
+                    if (profiler.writeCsv(path)) {
+                        logMessage(LogLevel::INFO, "Stage timings written to " + path);
+                    }
                 }
-            }
 
-            if (southCount <= 6)
-            {
-                if (!southQueue.empty()){
-                    vehicles.push_back(southQueue.front());
-                    southQueue.pop();
+                if (event.type == sf::Event::Closed){
+                    window.close();
+                    state = AppState::EXIT; // Fall through to the shutdown below
+                    isSimulation = false;
                 }
             }
 
-            if (eastCount <= 5)
-            {
-                if (!eastQueue.empty()){
-                    vehicles.push_back(eastQueue.front());
-                    eastQueue.pop();
-                }
+            if (sim.isFinished()) {
+                std::cout << "Simulation complete!" << std::endl;
+                window.close(); // Exit the simulation after the configured duration
+                state = AppState::EXIT;
+                break;
             }
 
-            if (westCount <= 5)
+            // Advance the engine in fixed steps for the real time since the last frame
+            int steps = simClock.stepsFor(moveClock.restart().asSeconds());
             {
-                if (!westQueue.empty()){
-                    vehicles.push_back(westQueue.front());
-                    westQueue.pop();
-                }
-            }
-
-            northEmergency = southEmergency = eastEmergency = westEmergency = false;
-            
-            
-            // spawn heavy cars only during minute 2-3. For one minute
-            if (elapsedTime >= 120 && elapsedTime <= 180)
-            {// Spawn heavy cars
-                if (heavyCarClock.getElapsedTime().asSeconds() >= 15.0f) {
-                    for (const std::string& direction : {"NORTH", "SOUTH", "EAST", "WEST"}) {
-                        VehicleSprite vehicle;
-                        vehicle.sprite.setTexture(heavyCarTexture);
-                        vehicle.speed = 45.0f;
-
-                        if (direction == "NORTH") {
-                            vehicle.sprite.setPosition(NORTH_SPAWN_HEAVY_LANE2);
-                            vehicle.sprite.setRotation(180);
-                        } else if (direction == "SOUTH") {
-                            vehicle.sprite.setPosition(SOUTH_SPAWN_HEAVY_LANE2);
-                        } else if (direction == "EAST") {
-                            vehicle.sprite.setPosition(EAST_SPAWN_HEAVY_LANE2);
-                            vehicle.sprite.setRotation(-90);
-                        } else if (direction == "WEST") {
-                            vehicle.sprite.setPosition(WEST_SPAWN_HEAVY_LANE2);
-                            vehicle.sprite.setRotation(90);
-                        }
-
-                        vehicle.direction = direction;
-                        vehicle.type = "H";
-                        vehicle.hasTurned = false;
-                        vehicle.plateNumber = generateRandomPlate();
-                        vehicle.mockSpeed = generateMockSpeed(vehicle.type);
-                        vehicles.push_back(vehicle);
+                ScopedStageTimer stepTimer(&profiler, Stage::STEP);
+                auto frameStart = std::chrono::steady_clock::now();
+                for (int s = 0; s < steps && !sim.isFinished(); ++s) {
+                    sim.step(simClock.getTimestep());
+                    // As fast as possible still has to leave time to draw the frame
+                    if (simClock.isUnbounded() && std::chrono::steady_clock::now() - frameStart > FAST_FRAME_BUDGET) {
+                        break;
                     }
-                    heavyCarClock.restart();
                 }
             }
-            else
-            {
-                heavyCarClock.restart();
+            elapsedTime = static_cast<float>(sim.getElapsedTime());
+
+            const VehicleStore& vehicles = sim.getVehicles();
+            const SignalState& signals = sim.getSignals();
+            northLight.setState(signals.approach[static_cast<int>(Direction::NORTH)]);
+            southLight.setState(signals.approach[static_cast<int>(Direction::SOUTH)]);
+            eastLight.setState(signals.approach[static_cast<int>(Direction::EAST)]);
+            westLight.setState(signals.approach[static_cast<int>(Direction::WEST)]);
+
+            // Only check the HUD at the refresh rate, panels re-layout only if a count changed.
+            // The engine keeps the counts up to date, so this never walks the vehicles.
+            if (hudInterval <= 0.0f || hudClock.getElapsedTime().asSeconds() >= hudInterval) {
+                ScopedStageTimer hudTimer(&profiler, Stage::HUD);
+                hudClock.restart();
+                const VehicleCounts& counts = sim.getVehicleCounts();
+                northPanel.update(counts.approaching[static_cast<int>(Direction::NORTH)]);
+                southPanel.update(counts.approaching[static_cast<int>(Direction::SOUTH)]);
+                eastPanel.update(counts.approaching[static_cast<int>(Direction::EAST)]);
+                westPanel.update(counts.approaching[static_cast<int>(Direction::WEST)]);
+                timer.update(elapsedTime, sim.getStats().vehiclesCleared, static_cast<int>(sim.getThroughputPerMinute()),
+                             violationPipeline.getOverflowCount());
             }
 
-            updateTrafficLights(northLight, southLight, eastLight, westLight, trafficCycleClock, cycleDuration, 4);
-
-            
-
-            // Inside the update loop
-            // I have updated the mock speed when the vehicle hasnt crossed the traffic lights
-            if (speedTimer.getElapsedTime().asSeconds() >= 5.0f) {
-                // Increase the mock speed of all vehicles
-                for (auto& vehicle : vehicles) {
-                    if (!vehicle.hasTurned)
-                        vehicle.mockSpeed += 5; 
+            // Mouse coordinates are debug output, only logged while debug is on and the mouse moves
+            if (isLogEnabled(LogLevel::DEBUG)) {
+                sf::Vector2i mousePosition = sf::Mouse::getPosition(window);
+                if (mousePosition.x != lastMousePosition.x || mousePosition.y != lastMousePosition.y) {
+                    lastMousePosition = mousePosition;
+                    logMessage(LogLevel::DEBUG, "Mouse Coordinates: (" + std::to_string(mousePosition.x) + ", " +
+                                                std::to_string(mousePosition.y) + ")");
                 }
-                speedTimer.restart(); // Reset the timer
             }
 
-            // implement the catching of vehicles here if they exceed the speed limit
-            // Check for speed violations
-            for (auto& vehicle : vehicles) {
-                if (!vehicle.hasTurned){
-                    int speedLimit = 0;
-
-                    // Determine the speed limit based on vehicle type
-                    if (vehicle.type == "R") {
-                        speedLimit = REGULAR_VEHICLE_SPEED_LIMIT;
-                    } else if (vehicle.type == "H") {
-                        speedLimit = HEAVY_VEHICLE_SPEED_LIMIT;
-                    } else if (vehicle.type == "E") {
-                        speedLimit = EMERGENCY_VEHICLE_SPEED_LIMIT;
-                    }
-
-                    // Check if the vehicle exceeds the speed limit
-                    if (vehicle.mockSpeed > speedLimit) {
-                        // Create a SpeedViolation object
-                        SpeedViolation violation = {
-                            vehicle.plateNumber, // Vehicle ID
-                            vehicle.type,        // vehicle type
-                            vehicle.mockSpeed,   // Current speed
-                            vehicle.direction,    // Direction of travel
-                            "Active"
-                        };
-
-                        // Add the violation to the queue
-                        {
-                            std::lock_guard<std::mutex> lock(queueMutex);
-                            violationQueue.push(violation);
-                        }
-                        vehicle.mockSpeed = 0;
-                        // Notify the challan thread
-                        violationNotifier.notify_one();
-                    }
-                }
-                
+            // The overlay's percentiles are only recomputed a couple of times a second
+            if (showProfiler && profilerClock.getElapsedTime().asSeconds() >= PROFILER_REFRESH_SECONDS) {
+                profilerClock.restart();
+                profilerText.setString(profiler.formatTable());
             }
 
-            // Reset counts before recalculating
-            northRegularCount = northEmergencyCount = northHeavyCount = 0;
-            southRegularCount = southEmergencyCount = southHeavyCount = 0;
-            eastRegularCount = eastEmergencyCount = eastHeavyCount = 0;
-            westRegularCount = westEmergencyCount = westHeavyCount = 0;
-
-            for (const auto& vehicle : vehicles) {
-                if (vehicle.direction == "NORTH") {
-                    if (vehicle.type == "R") ++northRegularCount;
-                    else if (vehicle.type == "E") ++northEmergencyCount;
-                    else if (vehicle.type == "H") ++northHeavyCount;
-                } else if (vehicle.direction == "SOUTH") {
-                    if (vehicle.type == "R") ++southRegularCount;
-                    else if (vehicle.type == "E") ++southEmergencyCount;
-                    else if (vehicle.type == "H") ++southHeavyCount;
-                } else if (vehicle.direction == "EAST") {
-                    if (vehicle.type == "R") ++eastRegularCount;
-                    else if (vehicle.type == "E") ++eastEmergencyCount;
-                    else if (vehicle.type == "H") ++eastHeavyCount;
-                } else if (vehicle.direction == "WEST") {
-                    if (vehicle.type == "R") ++westRegularCount;
-                    else if (vehicle.type == "E") ++westEmergencyCount;
-                    else if (vehicle.type == "H") ++westHeavyCount;
-                }
-            }
+            ScopedStageTimer drawTimer(&profiler, Stage::DRAW);
 
-            sf::Text northText, southText, eastText, westText;
-
-            // Set font and properties
-            northText.setFont(font);
-            northText.setCharacterSize(18);
-            northText.setFillColor(sf::Color::White);
-            northText.setPosition(750, 10); // Top-right corner
-
-            southText.setFont(font);
-            southText.setCharacterSize(18);
-            southText.setFillColor(sf::Color::White);
-            southText.setPosition(10, 900); // Bottom-left corner
-
-            eastText.setFont(font);
-            eastText.setCharacterSize(18);
-            eastText.setFillColor(sf::Color::White);
-            eastText.setPosition(750, 900); // Bottom-right corner
-
-            westText.setFont(font);
-            westText.setCharacterSize(18);
-            westText.setFillColor(sf::Color::White);
-            westText.setPosition(10, 10); // Top-left corner
-
-            // Update west text
-            westText.setString(
-                "West:\n" +
-                std::to_string(westRegularCount) + " Regular\n" +
-                std::to_string(westEmergencyCount) + " Emergency\n" +
-                std::to_string(westHeavyCount) + " Heavy\n"
-            );
-
-            // Update north text
-            northText.setString(
-                "North:\n" +
-                std::to_string(northRegularCount) + " Regular\n" +
-                std::to_string(northEmergencyCount) + " Emergency\n" +
-                std::to_string(northHeavyCount) + " Heavy\n"
-            );
-
-            // Update south text
-            southText.setString(
-                "South:\n" +
-                std::to_string(southRegularCount) + " Regular\n" +
-                std::to_string(southEmergencyCount) + " Emergency\n" +
-                std::to_string(southHeavyCount) + " Heavy\n"
-            );
-
-            // Update east text
-            eastText.setString(
-                "East:\n" +
-                std::to_string(eastRegularCount) + " Regular\n" +
-                std::to_string(eastEmergencyCount) + " Emergency\n" +
-                std::to_string(eastHeavyCount) + " Heavy\n"
-            );
-
-
-            // Move vehicles
-            float deltaTime = moveClock.restart().asSeconds();
+            // Rebuild the sprite batch, traffic lights first so vehicles draw over them
+            spriteBatch.clear();
+            spriteBatch.add(northLight.region, northLight.placement.getTransform());
+            spriteBatch.add(eastLight.region, eastLight.placement.getTransform());
+            spriteBatch.add(westLight.region, westLight.placement.getTransform());
+            spriteBatch.add(southLight.region, southLight.placement.getTransform());
             for (size_t i = 0; i < vehicles.size(); ++i) {
-                bool canMove = true;
-                bool canEmergencyPass = true;
-                srand(time(0));
-                
-                // Implement turning logic after crossnig signal
-                if (vehicles[i].direction == "NORTH" && vehicles[i].sprite.getPosition().y > 350) {
-                    // Randomly decide the next direction
-                    int turn = std::rand() % 3; // 0 = LEFT, 1 = STRAIGHT, 2 = RIGHT
-                    if (turn == 0) { // Turn LEFT
-                        vehicles[i].direction = "TURN_EAST";
-                    
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(WEST_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(WEST_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(WEST_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(WEST_TURN_LANE1); // Reposition to west lane
-                            }
-                            
-                        }
-
-                        vehicles[i].sprite.setRotation(-90); // Update rotation for westward movement
-                    } else if (turn == 1) { // Go STRAIGHT
-                        vehicles[i].direction = "TURN_NORTH";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(SOUTH_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(SOUTH_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(SOUTH_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(SOUTH_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                        
-                    } else if (turn == 2) { // Turn RIGHT
-                        vehicles[i].direction = "TURN_WEST";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(EAST_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(EAST_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(EAST_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(EAST_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                        vehicles[i].sprite.setRotation(90); // Update rotation for eastward movement
-                    }
-                    vehicles[i].hasTurned = true;                    
-                    continue; // Skip further checks for this car in the current frame
-                }
-
-                if (vehicles[i].direction == "SOUTH" && vehicles[i].sprite.getPosition().y < 650) {
-                    int turn = std::rand() % 3;
-                    if (turn == 0) {
-                        vehicles[i].direction = "TURN_WEST";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(EAST_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(EAST_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(EAST_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(EAST_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                        vehicles[i].sprite.setRotation(90);
-                    } else if (turn == 1) {
-                        vehicles[i].direction = "TURN_SOUTH";if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(NORTH_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(NORTH_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(NORTH_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(NORTH_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                    } else if (turn == 2) {
-                        vehicles[i].direction = "TURN_EAST";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(WEST_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(WEST_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(WEST_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(WEST_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                        vehicles[i].sprite.setRotation(-90);
-                    }
-                    vehicles[i].hasTurned = true;                    
-                    continue;
-                }
-
-                if (vehicles[i].direction == "EAST" && vehicles[i].sprite.getPosition().x < 650) {
-                    int turn = std::rand() % 3;
-                    if (turn == 0) {
-                        vehicles[i].direction = "TURN_SOUTH";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(NORTH_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(NORTH_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(NORTH_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(NORTH_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                        vehicles[i].sprite.setRotation(0);
-                    } else if (turn == 1) {
-                        vehicles[i].direction = "TURN_EAST";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(WEST_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(WEST_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(WEST_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(WEST_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                        //vehicles[i].sprite.setRotation(90);
-                    } else if (turn == 2) {
-                        vehicles[i].direction = "TURN_NORTH";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(SOUTH_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(SOUTH_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(SOUTH_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(SOUTH_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                        vehicles[i].sprite.setRotation(180);
-                    }
-                    vehicles[i].hasTurned = true;                    
-                    continue;
-                }
-
-                if (vehicles[i].direction == "WEST" && vehicles[i].sprite.getPosition().x > 350) {
-                    int turn = std::rand() % 3;
-                    if (turn == 0) {
-                        vehicles[i].direction = "TURN_NORTH";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(SOUTH_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(SOUTH_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(SOUTH_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(SOUTH_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                        vehicles[i].sprite.setRotation(180);
-                    } else if (turn == 1) {
-                        vehicles[i].direction = "TURN_WEST";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(EAST_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(EAST_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(EAST_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(EAST_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                    } else if (turn == 2) {
-                        vehicles[i].direction = "TURN_SOUTH";
-                        if (vehicles[i].type == "H") {
-                            vehicles[i].sprite.setPosition(NORTH_TURN_LANE2); // Reposition to west lane
-                        }
-                        else {
-                            if (elapsedTime < 120 || elapsedTime > 180)
-                            {
-                                int decide = std::rand() % 2;
-                                if (decide == 0)
-                                {
-                                    vehicles[i].sprite.setPosition(NORTH_TURN_LANE1); // Reposition to west lane
-                                }
-                                else
-                                {
-                                    vehicles[i].sprite.setPosition(NORTH_TURN_LANE2); // Reposition to west lane
-                                }
-                            }
-                            else
-                            {
-                                vehicles[i].sprite.setPosition(NORTH_TURN_LANE1); // Reposition to west lane
-                            }
-                        }
-                        vehicles[i].sprite.setRotation(0);
-                    }
-                    vehicles[i].hasTurned = true;                    
-                    continue;
-                }
-
-                // Scale vehicles based on type
-                if (vehicles[i].type == "R") {
-                    vehicles[i].sprite.setScale(0.55f, 0.55f);
-                } else if (vehicles[i].type == "E") {
-                    vehicles[i].sprite.setScale(0.55f, 0.55f);
-                } else if (vehicles[i].type == "H") {
-                    vehicles[i].sprite.setScale(0.70f, 0.70f); 
-                }
-
-                
-
-                // Check traffic light states and proximity to other vehicles
-                if (vehicles[i].direction == "NORTH") {
-                    if (!northLight.canPass() && vehicles[i].sprite.getPosition().y >= 300) {
-                        canMove = false; // Stop if at the traffic light
-                    }
-                    // Check whether emergency vehicle is top of the lane, if so let it move
-                    if (vehicles[i].type == "E") {
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "NORTH" && !vehicles[j].hasTurned && 
-                                vehicles[j].sprite.getPosition().y > vehicles[i].sprite.getPosition().y) {
-                                canEmergencyPass = false; // Another vehicle is ahead
-                                break;
-                            }
-                        }
-                    }
-                    if (vehicles[i].type == "H") {
-                        // Check for vehicle ahead
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "NORTH" && vehicles[j].type == "H" &&
-                                vehicles[j].sprite.getPosition().y > vehicles[i].sprite.getPosition().y &&
-                                vehicles[j].sprite.getPosition().y - vehicles[i].sprite.getPosition().y < 50.0f) { // Minimum gap
-                                canMove = false;
-                                break;
-                            }
-                        }
-                    }
-                    else {
-                        // Check for vehicle ahead
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "NORTH" &&
-                                vehicles[j].sprite.getPosition().y > vehicles[i].sprite.getPosition().y &&
-                                vehicles[j].sprite.getPosition().y - vehicles[i].sprite.getPosition().y < 50.0f) { // Minimum gap
-                                canMove = false;
-                                break;
-                            }
-                        }
-                    }
-                    
-                } else if (vehicles[i].direction == "SOUTH") {
-                    if (!southLight.canPass() && vehicles[i].sprite.getPosition().y <= 715) {
-                        canMove = false;
-                    }
-                    // Check whether emergency vehicle is top of the lane, if so let it move
-                    if (vehicles[i].type == "E") {
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "SOUTH" && !vehicles[j].hasTurned && 
-                                vehicles[j].sprite.getPosition().y < vehicles[i].sprite.getPosition().y) {
-                                canEmergencyPass = false; // Another vehicle is ahead
-                                break;
-                            }
-                        }
-                    }
-                    if (vehicles[i].type == "H") {
-                        // Check for vehicle ahead
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "SOUTH" && vehicles[j].type == "H" &&
-                                vehicles[j].sprite.getPosition().y < vehicles[i].sprite.getPosition().y &&
-                                vehicles[i].sprite.getPosition().y - vehicles[j].sprite.getPosition().y < 50.0f) { // Minimum gap
-                                canMove = false;
-                                break;
-                            }
-                        }
-                    }
-                    else
-                    {    // Check for vehicle ahead
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "SOUTH" &&
-                                vehicles[j].sprite.getPosition().y < vehicles[i].sprite.getPosition().y &&
-                                vehicles[i].sprite.getPosition().y - vehicles[j].sprite.getPosition().y < 50.0f) { // Minimum gap
-                                canMove = false;
-                                break;
-                            }
-                        }
-                    }
-                } else if (vehicles[i].direction == "EAST") {
-                    if (!eastLight.canPass() && vehicles[i].sprite.getPosition().x <= 700) {
-                        canMove = false;
-                    }
-
-                    // Check whether emergency vehicle is top of the lane, if so let it move
-                    if (vehicles[i].type == "E") {
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "EAST" && !vehicles[j].hasTurned && 
-                                vehicles[j].sprite.getPosition().x < vehicles[i].sprite.getPosition().x) {
-                                canEmergencyPass = false; // Another vehicle is ahead
-                                break;
-                            }
-                        }
-                    }
-                    if (vehicles[i].type == "H") {
-                        // Check for vehicle ahead
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "EAST" && vehicles[j].type == "H" &&
-                                vehicles[j].sprite.getPosition().x < vehicles[i].sprite.getPosition().x &&
-                                vehicles[i].sprite.getPosition().x - vehicles[j].sprite.getPosition().x < 50.0f) { // Minimum gap
-                                canMove = false;
-                                break;
-                            }
-                        }
-                    }
-                    else
-                    {    // Check for vehicle ahead
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "EAST" &&
-                                vehicles[j].sprite.getPosition().x < vehicles[i].sprite.getPosition().x &&
-                                vehicles[i].sprite.getPosition().x - vehicles[j].sprite.getPosition().x < 50.0f) { // Minimum gap
-                                canMove = false;
-                                break;
-                            }
-                        }
-                    }
-                } else if (vehicles[i].direction == "WEST") {
-                    if (!westLight.canPass() && vehicles[i].sprite.getPosition().x >= 290) {
-                        canMove = false;
-                    }
-
-                    // Check whether emergency vehicle is top of the lane, if so let it move
-                    if (vehicles[i].type == "E") {
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "WEST" && !vehicles[j].hasTurned && 
-                                vehicles[j].sprite.getPosition().x > vehicles[i].sprite.getPosition().x) {
-                                canEmergencyPass = false; // Another vehicle is ahead
-                                break;
-                            }
-                        }
-                    }
-                    if (vehicles[i].type == "H") {
-                        // Check for vehicle ahead
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "WEST" && vehicles[j].type == "H" &&
-                                vehicles[j].sprite.getPosition().x > vehicles[i].sprite.getPosition().x &&
-                                vehicles[j].sprite.getPosition().x - vehicles[i].sprite.getPosition().x < 50.0f) { // Minimum gap
-                                canMove = false;
-                                break;
-                            }
-                        }
-                    }
-                    else
-                    {    // Check for vehicle ahead
-                        for (size_t j = 0; j < vehicles.size(); ++j) {
-                            if (i != j && vehicles[j].direction == "WEST" &&
-                                vehicles[j].sprite.getPosition().x > vehicles[i].sprite.getPosition().x &&
-                                vehicles[j].sprite.getPosition().x - vehicles[i].sprite.getPosition().x < 50.0f) { // Minimum gap
-                                canMove = false;
-                                break;
-                            }
-                        }
-                    }
-                }
-
-
-
-                // Move the vehicle if allowed
-                if (canMove || (canEmergencyPass && vehicles[i].type == "E")) {
-                    if (vehicles[i].direction == "NORTH" || vehicles[i].direction == "TURN_NORTH") {
-                        vehicles[i].sprite.move(0, vehicles[i].speed * deltaTime);
-                    } else if (vehicles[i].direction == "SOUTH" || vehicles[i].direction == "TURN_SOUTH") {
-                        vehicles[i].sprite.move(0, -vehicles[i].speed * deltaTime);
-                    } else if (vehicles[i].direction == "EAST" || vehicles[i].direction == "TURN_EAST") {
-                        vehicles[i].sprite.move(-vehicles[i].speed * deltaTime, 0);
-                    } else if (vehicles[i].direction == "WEST" || vehicles[i].direction == "TURN_WEST") {
-                        vehicles[i].sprite.move(vehicles[i].speed * deltaTime, 0);
-                    }
-                }
-
+                // Atlas images for vehicles are in VehicleType order
+                int type = static_cast<int>(vehicles.type[i]);
+                sf::Transform transform;
+                transform.translate(vehicles.posX[i], vehicles.posY[i])
+                         .rotate(rotationFor(vehicles.direction[i]))
+                         .scale(VEHICLE_SCALE[type], VEHICLE_SCALE[type]);
+                spriteBatch.add(atlas.getRegion(REGULAR_CAR + type), transform);
             }
 
-            // Get the mouse position relative to the window
-            sf::Vector2i mousePosition = sf::Mouse::getPosition(window);
-
-            // Print mouse coordinates to the terminal
-            std::cout << "Mouse Coordinates: (" << mousePosition.x << ", " << mousePosition.y << ")\r";
-            std::flush(std::cout); // Ensure it continuously updates in the terminal
-
-
-            // Update timer text
-            int minutes = static_cast<int>(elapsedTime) / 60;
-            int seconds = static_cast<int>(elapsedTime) % 60;
-
-            timerText.setString("Time Left: " + std::to_string(minutes) + "m " + std::to_string(seconds) + "s");
-
             // Clear window and draw
             window.clear();
             window.draw(backgroundSprite);
-            window.draw(timerText); // Draw the timer
-
-            // Draw traffic light
-            // trafficLight.setFillColor((spawnClock.getElapsedTime().asSeconds() < 5.0f) ? sf::Color::Green : sf::Color::Red);
-            window.draw(northLight.lightSprite);
-            window.draw(eastLight.lightSprite);
-            window.draw(westLight.lightSprite);
-            window.draw(southLight.lightSprite);
-
+            window.draw(timer.text); // Draw the timer
 
-            window.draw(westText);
-            window.draw(northText);
-            window.draw(southText);
-            window.draw(eastText);
+            window.draw(westPanel.text);
+            window.draw(northPanel.text);
+            window.draw(southPanel.text);
+            window.draw(eastPanel.text);
 
+            // Draw traffic lights and vehicles, one draw call however many vehicles there are
+            spriteBatch.draw(window);
 
-            // Draw vehicles
-            for (const auto& vehicle : vehicles) {
-                window.draw(vehicle.sprite);
+            if (showProfiler) {
+                window.draw(profilerText);
             }
 
             // Display updated window
@@ -1760,7 +1092,17 @@ int main() {
     }
 
 
-    challanThread.join();
+    challanPool.shutdown(); // Issues whatever is still queued, then joins the workers
+    size_t droppedViolations = violationPipeline.getOverflowCount();
+    if (droppedViolations > 0) {
+        logMessage(LogLevel::WARN, "Challan pipeline dropped " + std::to_string(droppedViolations) + " violations");
+    }
+    challanStore.setLedger(nullptr);
+    ledger.close();         // Commits the last batch
+    if (!profileCsvPath.empty()) {
+        profiler.writeCsv(profileCsvPath);
+    }
+    stopLogger();           // Writes out whatever is still queued
     window.close();
     return 0;
 }